@@ -0,0 +1,122 @@
+#include "AccelSampler.h"
+#include "Stopwatch.h"
+
+#define ACCEL_RING_MASK (ACCEL_RING_SIZE - 1)
+
+/**
+ * Creates an empty ring.
+ */
+AccelRing::AccelRing()
+{
+	_pushed = 0;
+	_popped = 0;
+	_dropped = 0;
+}
+
+/**
+ * Adds a sample at the back of the ring. Called by the producer only.
+ * Returns false, dropping the sample, if the ring is full.
+ */
+bool AccelRing::push(const AccelSample& sample)
+{
+	unsigned int pushed = __sync_fetch_and_add(&_pushed, 0);
+	if(pushed - __sync_fetch_and_add(&_popped, 0) == ACCEL_RING_SIZE)
+	{
+		__sync_fetch_and_add(&_dropped, 1);
+		return false;
+	}
+	
+	// Fill the slot before publishing it.
+	_samples[pushed & ACCEL_RING_MASK] = sample;
+	__sync_fetch_and_add(&_pushed, 1);
+	return true;
+}
+
+/**
+ * Takes the sample at the front of the ring. Called by the consumer only.
+ * Returns false if the ring is empty.
+ */
+bool AccelRing::pop(AccelSample* sample)
+{
+	unsigned int popped = __sync_fetch_and_add(&_popped, 0);
+	if(__sync_fetch_and_add(&_pushed, 0) == popped)
+		return false;
+	
+	// Copy the slot out before handing it back to the producer.
+	*sample = _samples[popped & ACCEL_RING_MASK];
+	__sync_fetch_and_add(&_popped, 1);
+	return true;
+}
+
+/**
+ * Returns the number of samples dropped so far because the consumer fell behind.
+ */
+int AccelRing::dropped()
+{
+	return __sync_fetch_and_add(&_dropped, 0);
+}
+
+AccelSampler* AccelSampler::_active = NULL;
+
+/**
+ * Creates a sampler. No samples are taken until start() is called.
+ */
+AccelSampler::AccelSampler()
+{
+	_started = false;
+}
+
+/**
+ * Stops sampling, if started.
+ */
+AccelSampler::~AccelSampler()
+{
+	stop();
+}
+
+/**
+ * Starts queuing the accelerometer's readings. The accelerometer must already be
+ * set up. Called on the main thread, which the accelerometer reports on.
+ */
+void AccelSampler::start()
+{
+	if(_started)
+		return;
+	_active = this;
+	_started = true;
+	ofxAccelerometer.setCallback(accelerated);
+}
+
+/**
+ * Stops queuing readings. Called on the main thread.
+ */
+void AccelSampler::stop()
+{
+	if(!_started)
+		return;
+	ofxAccelerometer.setCallback(NULL);
+	_active = NULL;
+	_started = false;
+}
+
+/**
+ * Returns the ring the samples are queued on.
+ */
+AccelRing* AccelSampler::ring()
+{
+	return &_ring;
+}
+
+/**
+ * Called by the accelerometer on the main thread with each new raw reading.
+ * Queues the reading, stamped with the time it arrived.
+ */
+void AccelSampler::accelerated(ofPoint& accel)
+{
+	if(_active == NULL)
+		return;
+	AccelSample sample;
+	sample.micros = Stopwatch::nowMicros();
+	sample.accel = Vec2(accel.x, accel.y);
+	_active->_ring.push(sample);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Vec2.h"
+
+// The number of samples an AccelRing holds. Must be a power of two.
+#define ACCEL_RING_SIZE 64
+
+/**
+ * A single reading of the accelerometer.
+ */
+struct AccelSample
+{
+	long long micros; // When the accelerometer delivered the reading, on the Stopwatch clock.
+	Vec2 accel; // The raw acceleration, in the accelerometer's own axes.
+};
+
+/**
+ * A fixed-size queue of samples between one producing and one consuming thread.
+ * Each side owns one counter and only reads the other's, so neither ever
+ * takes a lock or waits. When the consumer falls a whole ring behind,
+ * new samples are dropped until it catches up.
+ */
+class AccelRing
+{
+private:
+	
+	AccelSample _samples[ACCEL_RING_SIZE];
+	volatile unsigned int _pushed; // The number of samples ever pushed. Written by the producer.
+	volatile unsigned int _popped; // The number of samples ever popped. Written by the consumer.
+	volatile unsigned int _dropped; // The number of samples dropped because the ring was full.
+
+public:
+	
+	AccelRing();
+	
+	bool push(const AccelSample& sample);
+	bool pop(AccelSample* sample);
+	
+	int dropped();
+};
+
+/**
+ * Queues every reading the accelerometer delivers, stamped with when it arrived,
+ * for the simulation to consume. The readings are pushed from the accelerometer's
+ * own callback on the main thread, so nothing else ever reads the accelerometer's
+ * state while it changes, and each sample's time is when the sensor reported it,
+ * which lets the simulation filter the readings consistently and measure how old
+ * its input is. Only one sampler can be started at a time.
+ */
+class AccelSampler
+{
+private:
+	
+	AccelRing _ring;
+	bool _started;
+	
+	static AccelSampler* _active; // The started sampler, or NULL.
+	
+	static void accelerated(ofPoint& accel);
+
+public:
+	
+	AccelSampler();
+	~AccelSampler();
+	
+	void start();
+	void stop();
+	
+	AccelRing* ring();
+};
@@ -2,7 +2,40 @@
 #include "AppState.h"
 #include "Game.h"
 #include "GenericLevel.h"
+#include "StressBenchmark.h"
+#include "ThreadPool.h"
+#include "GravityPolicy.h"
+#include "Stopwatch.h"
+#include "Trace.h"
 #include "rules.h"
+#include <unistd.h>
+
+/**
+ * Creates the application. Nothing is loaded until setup() is called.
+ */
+App::App()
+	: _renderer(this)
+{
+	_curLevel = 0;
+	_lastPublished = NULL;
+	_undrawnChanges = 0;
+	_undrawnMoves = 0;
+	_qualityLevel = 0;
+	_drawMicros = 0;
+	_traceFlushMicros = 0;
+	_simThreadStarted = false;
+	_simStopping = 0;
+	pthread_mutex_init(&_touchLock, NULL);
+}
+
+/**
+ * Stops the simulation thread, if it is running.
+ */
+App::~App()
+{
+	stopSimulation();
+	pthread_mutex_destroy(&_touchLock);
+}
 
 /**
  * Called by Open Frameworks when the application should be initialized.
@@ -10,32 +43,94 @@
  */
 void App::setup()
 {
+	TRACE_THREAD("main");
 	ofxAccelerometer.setup();
+	if(ACCEL_SAMPLER)
+		_accelSampler.start();
 	ofxMultiTouch.addListener(this);
 	ofEnableAlphaBlending();
+	ofBackground(0, 0, 0);
+	ofSetBackgroundAuto(true);
+	ofSetFrameRate(PACE_FULL_RATE);
 	ttfontBig.loadFont(ofToDataPath("verdana.ttf"), 50);
 	ttfontSmall.loadFont(ofToDataPath("verdana.ttf"), 12);
+	_updatePool = shared_ptr<ThreadPool>(new ThreadPool(ThreadPool::coreCount() - 1));
+	if(TELEMETRY && !_telemetry.create())
+		printf("telemetry: could not create %s\n", TELEMETRY_NAME);
 	
-	nextLevel();
+	if(STRESS_BENCHMARK)
+		switchState(shared_ptr<AppState>(new StressBenchmark(this)));
+	else
+		nextLevel();
+	
+	if(SIM_THREAD)
+		startSimulation();
 }
 
 /**
  * Called by Open Frameworks when the game logic should be updated.
+ * Ticks the state unless the simulation thread is running, and with TRACING
+ * set, flushes the trace every TRACE_FLUSH_MICROS.
  */
 void App::update()
 {
-	_curState = _nextState; // Switch to next state here.
-	if(_curState)
-		_curState->update();
+	TRACE_SCOPE("App::update");
+	if(!_simThreadStarted)
+		tick();
+	
+	// Flush the trace every so often, before the threads' rings wrap around.
+	if(TRACING && Stopwatch::nowMicros() >= _traceFlushMicros)
+	{
+		TRACE_SCOPE("flush trace");
+		Tracer::flush(ofToDataPath(TRACE_FILE).c_str());
+		_traceFlushMicros = Stopwatch::nowMicros() + TRACE_FLUSH_MICROS;
+	}
 }
 
 /**
  * Called by Open Frameworks when the game should be rendered to the display.
+ * Draws the latest snapshot the simulation has published, without waiting for the next.
  */
 void App::draw()
 {
-	if(_curState)
-		_curState->draw();
+	TRACE_SCOPE("App::draw");
+	Stopwatch stopwatch;
+	RenderSnapshot* snapshot = _renderBuffer.latest();
+	if(OFFSCREEN_TARGET && _target.begin())
+	{
+		_renderer.setPixelScale(_target.drawScale());
+		TRACE_BEGIN("draw snapshot");
+		snapshot->draw(&_renderer);
+		TRACE_END("draw snapshot");
+		TRACE_BEGIN("draw target");
+		_target.end();
+		TRACE_END("draw target");
+	}
+	else
+	{
+		_renderer.setPixelScale(1);
+		TRACE_BEGIN("draw snapshot");
+		snapshot->draw(&_renderer);
+		TRACE_END("draw snapshot");
+	}
+	
+	long long drawMicros = stopwatch.elapsedMicros();
+	__sync_lock_test_and_set(&_drawMicros, (int)drawMicros);
+	
+	// Pace by everything that changed since the previous draw, including in
+	// snapshots that were published but replaced before they could be drawn.
+	int changes = __sync_lock_test_and_set(&_undrawnChanges, 0);
+	int moves = __sync_lock_test_and_set(&_undrawnMoves, 0);
+	if(FRAME_PACING && _simThreadStarted)
+		_pacer.drew(changes, moves);
+	
+	// Judge the frame by whichever of recording and drawing it took longer.
+	if(QUALITY_SCALING)
+	{
+		_quality.frameTook(max(drawMicros, snapshot->tickMicros()));
+		_target.setScale(RENDER_SCALE * QualityScaler::quality(_quality.level())->renderScale);
+		__sync_lock_test_and_set(&_qualityLevel, _quality.level());
+	}
 }
 
 /**
@@ -43,7 +138,146 @@ void App::draw()
  */
 void App::exit()
 {
+	stopSimulation();
+	_accelSampler.stop();
+	if(FRAME_PACING)
+		_pacer.print();
+	if(QUALITY_SCALING)
+		_quality.print();
+	if(TRACING)
+		Tracer::flush(ofToDataPath(TRACE_FILE).c_str());
+}
+
+/**
+ * Advances the current state by one tick and publishes what it looks like.
+ * Called on the simulation thread, or on the main thread if there is none.
+ */
+void App::tick()
+{
+	TRACE_SCOPE("App::tick");
+	_curState = _nextState; // Switch to next state here.
+	handleTouches();
 	
+	Stopwatch stopwatch;
+	RenderSnapshot* snapshot = _renderBuffer.writing();
+	snapshot->clear();
+	if(_curState)
+	{
+		_curState->update();
+		_curState->render(snapshot);
+	}
+	snapshot->setTickMicros(stopwatch.elapsedMicros());
+	if(RENDER_SORT)
+	{
+		TRACE_SCOPE("sort");
+		snapshot->sort();
+	}
+	snapshot->compare(_lastPublished);
+	__sync_fetch_and_add(&_undrawnChanges, snapshot->changes());
+	__sync_fetch_and_add(&_undrawnMoves, snapshot->moves());
+	_lastPublished = snapshot;
+	_renderBuffer.publish();
+}
+
+/**
+ * Starts updating the current state on a simulation thread at SIM_TICK_RATE.
+ */
+void App::startSimulation()
+{
+	if(_simThreadStarted)
+		return;
+	_simStopping = 0;
+	_simThreadStarted = true;
+	pthread_create(&_simThread, NULL, simMain, this);
+}
+
+/**
+ * Stops the simulation thread after its current tick and waits for it to finish.
+ * The main thread then updates the state itself.
+ */
+void App::stopSimulation()
+{
+	if(!_simThreadStarted)
+		return;
+	__sync_lock_test_and_set(&_simStopping, 1);
+	pthread_join(_simThread, NULL);
+	_simThreadStarted = false;
+	_pacer.wake();
+}
+
+/**
+ * The body of the simulation thread. Ticks at SIM_TICK_RATE until asked to stop.
+ * A tick that runs late is followed immediately by the next, to catch up, unless
+ * the simulation has fallen more than SIM_MAX_LAG_TICKS behind, in which case
+ * the lost time is dropped rather than made up in a burst.
+ */
+void* App::simMain(void* arg)
+{
+	App* app = (App*)arg;
+	TRACE_THREAD("simulation");
+	long long tickMicros = 1000000 / SIM_TICK_RATE;
+	long long nextTick = Stopwatch::nowMicros();
+	while(!__sync_fetch_and_add(&app->_simStopping, 0))
+	{
+		app->tick();
+		
+		nextTick += tickMicros;
+		long long now = Stopwatch::nowMicros();
+		if(nextTick > now)
+			usleep(nextTick - now);
+		else if(now - nextTick > SIM_MAX_LAG_TICKS * tickMicros)
+			nextTick = now;
+	}
+	return NULL;
+}
+
+/**
+ * Queues a touch event for the simulation thread to pass on at the start of its next tick.
+ */
+void App::queueTouch(TouchEventType type, float x, float y, int touchId)
+{
+	TouchEvent event;
+	event.type = type;
+	event.x = x;
+	event.y = y;
+	event.touchId = touchId;
+	pthread_mutex_lock(&_touchLock);
+	_touches.push_back(event);
+	pthread_mutex_unlock(&_touchLock);
+}
+
+/**
+ * Passes the queued touch events on to the current state, in the order they happened.
+ */
+void App::handleTouches()
+{
+	pthread_mutex_lock(&_touchLock);
+	_touchesToHandle.swap(_touches);
+	pthread_mutex_unlock(&_touchLock);
+	
+	if(_curState)
+	{
+		vector<TouchEvent>::iterator iter;
+		for(iter = _touchesToHandle.begin(); iter != _touchesToHandle.end(); ++iter)
+		{
+			switch(iter->type)
+			{
+				case TOUCH_DOWN:
+					_curState->touchDown(iter->x, iter->y, iter->touchId);
+					break;
+				case TOUCH_MOVED:
+					_curState->touchMoved(iter->x, iter->y, iter->touchId);
+					break;
+				case TOUCH_UP:
+					_curState->touchUp(iter->x, iter->y, iter->touchId);
+					break;
+				case TOUCH_DOUBLE_TAP:
+					_curState->touchDoubleTap(iter->x, iter->y, iter->touchId);
+					break;
+			}
+		}
+	}
+	_touchesToHandle.clear();
 }
 
 /**
@@ -51,10 +285,18 @@ void App::exit()
  */
 void App::resetLevel()
 {
+	TRACE_INSTANT("reset level");
 	if(_curLevel - 1 < LEVEL_COUNT)
 	{
 		LevelBase* level = new GenericLevel(levels[_curLevel - 1]);
-		switchState(shared_ptr<AppState>(new Game(this, shared_ptr<LevelBase>(level))));
+		Game* game = new Game(this, shared_ptr<LevelBase>(level));
+		if(PARALLEL_UPDATE)
+			game->setUpdatePool(_updatePool.get());
+		if(PARALLEL_RENDER)
+			game->setRenderPool(_updatePool.get());
+		if(ACCEL_SAMPLER)
+			game->setGravityPolicy(shared_ptr<GravityPolicy>(new SampledGravity(_accelSampler.ring())));
+		switchState(shared_ptr<AppState>(game));
 	}
 	else
 	{
@@ -67,17 +309,32 @@ void App::resetLevel()
  */
 void App::nextLevel()
 {
+	TRACE_INSTANT("next level");
 	_curLevel++;
 	resetLevel();
 }
 
+/**
+ * Converts a touch location in the window to the logical screen the game is drawn in.
+ */
+Vec2 App::toLogical(float x, float y)
+{
+	if(OFFSCREEN_TARGET)
+		return _target.toLogical(Vec2(x, y));
+	return Vec2(x, y);
+}
+
 /**
  * Called by Open Frameworks when a touch event has started.
  */
 void App::touchDown(float x, float y, int touchId, ofxMultiTouchCustomData *data)
 {
-	if(_curState)
-		_curState->touchDown(x, y, touchId, data);
+	Vec2 loc = toLogical(x, y);
+	_pacer.wake();
+	if(_simThreadStarted)
+		queueTouch(TOUCH_DOWN, loc.x, loc.y, touchId);
+	else if(_curState)
+		_curState->touchDown(loc.x, loc.y, touchId, data);
 }
 
 /**
@@ -85,8 +342,12 @@ void App::touchDown(float x, float y, int touchId, ofxMultiTouchCustomData *data
  */
 void App::touchMoved(float x, float y, int touchId, ofxMultiTouchCustomData *data)
 {
-	if(_curState)
-		_curState->touchMoved(x, y, touchId, data);
+	Vec2 loc = toLogical(x, y);
+	_pacer.wake();
+	if(_simThreadStarted)
+		queueTouch(TOUCH_MOVED, loc.x, loc.y, touchId);
+	else if(_curState)
+		_curState->touchMoved(loc.x, loc.y, touchId, data);
 }
 
 /**
@@ -94,8 +355,12 @@ void App::touchMoved(float x, float y, int touchId, ofxMultiTouchCustomData *dat
  */
 void App::touchUp(float x, float y, int touchId, ofxMultiTouchCustomData *data)
 {
-	if(_curState)
-		_curState->touchUp(x, y, touchId, data);
+	Vec2 loc = toLogical(x, y);
+	_pacer.wake();
+	if(_simThreadStarted)
+		queueTouch(TOUCH_UP, loc.x, loc.y, touchId);
+	else if(_curState)
+		_curState->touchUp(loc.x, loc.y, touchId, data);
 }
 
 /**
@@ -103,8 +368,12 @@ void App::touchUp(float x, float y, int touchId, ofxMultiTouchCustomData *data)
  */
 void App::touchDoubleTap(float x, float y, int touchId, ofxMultiTouchCustomData *data)
 {
-	if(_curState)
-		_curState->touchDoubleTap(x, y, touchId, data);
+	Vec2 loc = toLogical(x, y);
+	_pacer.wake();
+	if(_simThreadStarted)
+		queueTouch(TOUCH_DOUBLE_TAP, loc.x, loc.y, touchId);
+	else if(_curState)
+		_curState->touchDoubleTap(loc.x, loc.y, touchId, data);
 }
 
 /**
@@ -113,6 +382,7 @@ void App::touchDoubleTap(float x, float y, int touchId, ofxMultiTouchCustomData
  */
 void App::switchState(shared_ptr<AppState> state)
 {
+	TRACE_SCOPE("App::switchState");
 	if(state != _nextState)
 	{
 		if(_nextState != NULL)
@@ -123,6 +393,32 @@ void App::switchState(shared_ptr<AppState> state)
 	}
 }
 
+/**
+ * Returns the quality level the current state should record its frames at.
+ * Safe to call from the simulation thread.
+ */
+int App::qualityLevel()
+{
+	return __sync_fetch_and_add(&_qualityLevel, 0);
+}
+
+/**
+ * Returns how long the latest draw took, in microseconds.
+ * Safe to call from the simulation thread.
+ */
+int App::drawMicros()
+{
+	return __sync_fetch_and_add(&_drawMicros, 0);
+}
+
+/**
+ * Returns the ring the game writes its per-frame stats to. Open only with TELEMETRY set.
+ */
+TelemetryRing* App::telemetry()
+{
+	return &_telemetry;
+}
+
 /**
  * Returns the current 1-based level number.
  */
@@ -131,6 +427,15 @@ int App::levelNum()
 	return _curLevel;
 }
 
+/**
+ * Returns the thread pool on which games update their objects when PARALLEL_UPDATE
+ * is set, and record them for drawing when PARALLEL_RENDER is.
+ */
+ThreadPool* App::updatePool()
+{
+	return _updatePool.get();
+}
+
 /**
  * Returns the Open Frameworks font object to use for large text.
  */
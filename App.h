@@ -1,10 +1,51 @@
 #pragma once
 
+#include "RenderBuffer.h"
+#include "AccelSampler.h"
+#include "GLRenderer.h"
+#include "OffscreenTarget.h"
+#include "FramePacer.h"
+#include "QualityScaler.h"
+#include "Telemetry.h"
+#include <pthread.h>
+
 class AppState;
+class ThreadPool;
+
+/**
+ * The kinds of touch events the application passes on to its state.
+ */
+enum TouchEventType
+{
+	TOUCH_DOWN,
+	TOUCH_MOVED,
+	TOUCH_UP,
+	TOUCH_DOUBLE_TAP
+};
+
+/**
+ * A touch event waiting for the simulation thread.
+ */
+struct TouchEvent
+{
+	TouchEventType type;
+	float x;
+	float y;
+	int touchId;
+};
 
 /**
  * The class that controls high-level application logic.
- * Contains the main state system to which update, draw, and input events are sent.
+ * Contains the main state system to which update, render, and input events are sent.
+ * With SIM_THREAD set, the state is updated on a simulation thread of its own at a
+ * fixed tick rate, and the main thread only draws the latest RenderSnapshot, so the
+ * costs of updating and drawing overlap. Touch events are queued for the simulation
+ * thread, and with FRAME_PACING set, the main thread draws less often while the
+ * frames barely change. Otherwise the main thread updates the state and draws it in turn.
+ * With QUALITY_SCALING set, a QualityScaler lowers what is drawn while frames run long.
+ * With OFFSCREEN_TARGET set, frames are drawn into an OffscreenTarget and stretched
+ * over the window, and touches are converted back to the game's logical screen.
+ * With TELEMETRY set, the game writes every frame's stats to a TelemetryRing.
  */
 class App : public ofSimpleApp, public ofxMultiTouchListener
 {
@@ -13,16 +54,48 @@ private:
 	shared_ptr<AppState> _curState;
 	shared_ptr<AppState> _nextState;
 	int _curLevel;
+	shared_ptr<ThreadPool> _updatePool;
+	RenderBuffer _renderBuffer;
+	GLRenderer _renderer;
+	OffscreenTarget _target;
+	FramePacer _pacer;
+	QualityScaler _quality;
+	volatile int _qualityLevel; // The quality to record at, set atomically by the main thread.
+	volatile int _drawMicros; // The time the latest draw took, set atomically by the main thread.
+	long long _traceFlushMicros; // When the main thread next flushes the trace.
+	TelemetryRing _telemetry;
+	RenderSnapshot* _lastPublished; // The snapshot the latest tick published. Owned by the simulation.
+	volatile int _undrawnChanges; // Items changed by the ticks since the latest draw, added to atomically.
+	volatile int _undrawnMoves; // Of those, the items outside the dust that moved, appeared, or disappeared.
+	AccelSampler _accelSampler;
+	pthread_t _simThread;
+	bool _simThreadStarted;
+	volatile int _simStopping; // Set atomically to ask the simulation thread to stop.
+	pthread_mutex_t _touchLock; // Guards _touches.
+	vector<TouchEvent> _touches;
+	vector<TouchEvent> _touchesToHandle;
 	ofTrueTypeFont ttfontBig;
 	ofTrueTypeFont ttfontSmall;
 	
+	void tick();
+	void queueTouch(TouchEventType type, float x, float y, int touchId);
+	void handleTouches();
+	Vec2 toLogical(float x, float y);
+	static void* simMain(void* arg);
+	
 public:
 	
+	App();
+	~App();
+	
 	void setup();
 	void update();
 	void draw();
 	void exit();
 	
+	void startSimulation();
+	void stopSimulation();
+	
 	void resetLevel();
 	void nextLevel();
 	
@@ -34,6 +107,10 @@ public:
 	void switchState(shared_ptr<AppState> state);
 	
 	int levelNum();
+	int qualityLevel();
+	int drawMicros();
+	TelemetryRing* telemetry();
+	ThreadPool* updatePool();
 	ofTrueTypeFont* fontBig();
 	ofTrueTypeFont* fontSmall();
 };
@@ -1,8 +1,12 @@
 #pragma once
 
+class RenderSnapshot;
+
 /**
  * The base class for states usable in the App object's FSM.
- * Contains activate, deactivate, update, draw, and input events.
+ * Contains activate, deactivate, update, render, and input events.
+ * Every method is called on the simulation thread. render() records what the
+ * state looks like into a snapshot that the application draws later.
  */
 class AppState
 {
@@ -11,7 +15,7 @@ public:
 	virtual void activate(){};
 	virtual void deactivate(){};
 	virtual void update(){};
-	virtual void draw(){};
+	virtual void render(RenderSnapshot* snapshot){};
 	
 	virtual void touchDown(float x, float y, int touchId, ofxMultiTouchCustomData *data = NULL){};
 	virtual void touchMoved(float x, float y, int touchId, ofxMultiTouchCustomData *data = NULL){};
@@ -2,6 +2,10 @@
 #include "rules.h"
 #include "Game.h"
 #include "Enemy.h"
+#include "Snapshot.h"
+#include "RenderSnapshot.h"
+#include "CommandBuffer.h"
+#include <float.h>
 
 /**
  * Creates a new Bullet to be placed in the game.
@@ -10,12 +14,54 @@
  * @param loc The initial location of this Bullet.
  * @param vel The initial velocity of this bullet.
  */
-Bullet::Bullet(Game* game, BulletRules* rules, ofPoint loc, ofPoint vel)
+Bullet::Bullet(Game* game, BulletRules* rules, Vec2 loc, Vec2 vel)
 	: GameObject(game)
 {
 	_rules = rules;
 	_loc = loc;
 	_vel = vel;
+	_predicted = false;
+	_hitEnemy = NULL;
+	_hitFrame = -1;
+	_hitTimer = 0;
+	_hitDue = false;
+	_searched = false;
+}
+
+/**
+ * Recreates a bullet from the state written by save().
+ * Hit predictions aren't saved; the hit predictor makes them again.
+ */
+Bullet::Bullet(Game* game, Snapshot* snapshot)
+	: GameObject(game)
+{
+	_rules = snapshot->read<BulletRules*>();
+	_loc = snapshot->read<Vec2>();
+	_vel = snapshot->read<Vec2>();
+	_predicted = false;
+	_hitEnemy = NULL;
+	_hitFrame = -1;
+	_hitTimer = 0;
+	_hitDue = false;
+	_searched = false;
+}
+
+/**
+ * Writes this bullet's state to a snapshot.
+ */
+void Bullet::save(Snapshot* snapshot)
+{
+	snapshot->write(_rules);
+	snapshot->write(_loc);
+	snapshot->write(_vel);
+}
+
+/**
+ * Destroys this bullet, cancelling any predicted hit.
+ */
+Bullet::~Bullet()
+{
+	_game->timers()->cancel(_hitTimer);
 }
 
 /**
@@ -23,50 +69,245 @@ Bullet::Bullet(Game* game, BulletRules* rules, ofPoint loc, ofPoint vel)
  */
 void Bullet::update()
 {
-	// Apply velocity to location and accelerometer acceleration to velocity.
-	_loc += _vel;
-	ofPoint rawAccel = ofxAccelerometer.getRawAcceleration();
-	ofPoint fixedAccel = ofPoint(rawAccel.x, -rawAccel.y);
-	_vel += fixedAccel * _rules->gravityFactor;
-	
+	// Apply velocity to location and gravity to velocity.
+	_stepFrom = _loc;
+	step(&_loc, &_vel, _game->gravity(), _rules);
+	_searched = false;
+	resolve(false, NULL);
+}
+
+/**
+ * Takes this frame's step and, unless the hit predictor already knows the outcome,
+ * records a hit on the enemy the step would hit if nothing had been removed so far
+ * this frame. Touches nothing but this bullet and the buffer, so the game may advance
+ * many bullets at once ahead of their turn in the frame.
+ * @param tests Incremented by the number of enemies tested.
+ */
+void Bullet::advance(CommandBuffer* commands, int* tests)
+{
+	_stepFrom = _loc;
+	step(&_loc, &_vel, _game->gravity(), _rules);
+	_searched = false;
+	if(isOffScreen(_loc, _rules) || _predicted)
+		return;
+	Enemy* candidate = findHit(false, tests);
+	if(candidate != NULL)
+		commands->hit(_addOrder, candidate);
+	_searched = true;
+}
+
+/**
+ * Acts on the latest step: removes this bullet if it left the screen, or hits
+ * the first enemy it touched. Called at this bullet's turn in the frame.
+ * @param speculative Whether the hit recorded by advance() can be trusted, which it can
+ * unless enemies have changed course since. It is then used unless its enemy has been removed.
+ * @param candidate The enemy advance() recorded a hit on, or NULL if it recorded none.
+ */
+void Bullet::resolve(bool speculative, Enemy* candidate)
+{
 	// Remove if off screen.
-	if(_loc.x + _rules->radius + BULLET_DELETE_THRESHOLD < 0 ||
-	   _loc.x - _rules->radius - BULLET_DELETE_THRESHOLD > SCREEN_WIDTH ||
-	   _loc.y + _rules->radius + BULLET_DELETE_THRESHOLD < 0 ||
-	   _loc.y - _rules->radius - BULLET_DELETE_THRESHOLD > SCREEN_HEIGHT)
+	if(isOffScreen(_loc, _rules))
 	{
 		_game->delayRemoveGameObject(this);
 		return;
 	}
 	
-	// Check for collision with each enemy.
+	// If the hit predictor knows which enemy this bullet hits first, and when,
+	// there is nothing to test until then.
+	if(_predicted)
+	{
+		if(!_hitDue)
+			return;
+		if(!_game->isMarkedForRemoval(_hitEnemy))
+		{
+			_game->hitObject(_hitEnemy);
+			_game->delayRemoveGameObject(this);
+			return;
+		}
+		clearPrediction();
+	}
+	
+	// Removing enemies only takes candidates away, so the first enemy touched
+	// among all of them is still first among the rest if it is still here.
+	Enemy* hitEnemy;
+	if(speculative && _searched && (candidate == NULL || !_game->isMarkedForRemoval(candidate)))
+	{
+		hitEnemy = candidate;
+	}
+	else
+	{
+		hitEnemy = findHit(true, &_game->stats()->collisionTests);
+	}
+	if(hitEnemy != NULL)
+	{
+		_game->hitObject(hitEnemy);
+		_game->delayRemoveGameObject(this);
+	}
+}
+
+/**
+ * Sweeps the latest step against each enemy's step and returns whichever enemy
+ * it touches first, or NULL. Each enemy is taken where it was at this bullet's turn.
+ * @param skipRemoved Whether to ignore enemies marked for removal.
+ * @param tests Incremented by the number of enemies tested.
+ */
+Enemy* Bullet::findHit(bool skipRemoved, int* tests)
+{
+	Enemy* hitEnemy = NULL;
+	float hitTime = FLT_MAX;
 	vector<Enemy*>::iterator iter;
 	for(iter = _game->enemiesBegin(); iter != _game->enemiesEnd(); ++iter)
 	{
-		if(!(*iter)->isOnScreen() || _game->isMarkedForRemoval(*iter))
+		Vec2 enemyFrom;
+		Vec2 enemyTo;
+		(*iter)->stepAsOf(_addOrder, &enemyFrom, &enemyTo);
+		if(!(*iter)->isOnScreen(enemyTo) || (skipRemoved && _game->isMarkedForRemoval(*iter)))
 			continue;
 		
-		// Check circle intersection between this bullet and the enemy.
-		ofPoint diff = _loc - (*iter)->loc();
-		float length = sqrt(diff.x*diff.x + diff.y*diff.y);
-		if(length < (*iter)->rules()->radius + _rules->radius)
+		(*tests)++;
+		float time = contactTime(_stepFrom, _loc, _rules, enemyFrom, enemyTo, (*iter)->rules());
+		if(time >= 0 && time < hitTime)
 		{
-			(*iter)->hit();
-			_game->delayRemoveGameObject(this);
-			return;
+			hitEnemy = *iter;
+			hitTime = time;
 		}
 	}
+	return hitEnemy;
+}
+
+/**
+ * Records that this bullet will hit the specified enemy during the specified frame
+ * and will not touch any enemy before then, and schedules the hit.
+ */
+void Bullet::predictHit(Enemy* enemy, int frame)
+{
+	clearPrediction();
+	_predicted = true;
+	_hitEnemy = enemy;
+	_hitFrame = frame;
+	if(frame <= _game->timers()->now())
+		_hitDue = true;
+	else
+		_hitTimer = _game->timers()->schedule(frame, this, 0);
+}
+
+/**
+ * Records that this bullet will leave the screen without touching any enemy.
+ */
+void Bullet::predictMiss()
+{
+	clearPrediction();
+	_predicted = true;
+}
+
+/**
+ * Forgets any prediction for this bullet. It goes back to testing every enemy each frame.
+ */
+void Bullet::clearPrediction()
+{
+	_game->timers()->cancel(_hitTimer);
+	_predicted = false;
+	_hitEnemy = NULL;
+	_hitFrame = -1;
+	_hitTimer = 0;
+	_hitDue = false;
+}
+
+/**
+ * Returns whether this bullet currently has a prediction, hit or miss.
+ */
+bool Bullet::hasPrediction()
+{
+	return _predicted;
+}
+
+/**
+ * Returns the enemy this bullet is predicted to hit, or NULL if none.
+ */
+Enemy* Bullet::predictedEnemy()
+{
+	return _hitEnemy;
+}
+
+/**
+ * Returns the frame during which this bullet is predicted to hit, or -1 if it isn't.
+ */
+int Bullet::predictedFrame()
+{
+	return _hitFrame;
+}
+
+/**
+ * Called by the timer wheel at the start of the frame of the predicted hit.
+ */
+void Bullet::timerFired(int tag)
+{
+	_hitTimer = 0;
+	_hitDue = true;
+}
+
+/**
+ * Advances a bullet's location and velocity by one frame.
+ * Shared by update() and the hit predictor so that predicted paths match exactly.
+ */
+void Bullet::step(Vec2* loc, Vec2* vel, Vec2 gravity, BulletRules* rules)
+{
+	*loc += *vel;
+	*vel += gravity * rules->gravityFactor;
+}
+
+/**
+ * Returns whether a bullet at the specified location is far enough off screen to be removed.
+ */
+bool Bullet::isOffScreen(Vec2 loc, BulletRules* rules)
+{
+	return loc.x + rules->radius + BULLET_DELETE_THRESHOLD < 0 ||
+	       loc.x - rules->radius - BULLET_DELETE_THRESHOLD > SCREEN_WIDTH ||
+	       loc.y + rules->radius + BULLET_DELETE_THRESHOLD < 0 ||
+	       loc.y - rules->radius - BULLET_DELETE_THRESHOLD > SCREEN_HEIGHT;
+}
+
+/**
+ * Sweeps a bullet and an enemy along one step each and returns when they first touch,
+ * from 0 at the start of the step to 1 at the end, or -1 if they don't.
+ * Testing only where the step ends would let a fast bullet pass right through
+ * an enemy, so this tests the whole segment of the bullet's motion relative to
+ * the enemy against the enemy's circle expanded by the bullet's radius.
+ * @param from The bullet's location at the start of the step.
+ * @param to The bullet's location at the end of the step.
+ * @param rules The bullet's rules.
+ * @param enemyFrom The enemy's location at the start of its step.
+ * @param enemyTo The enemy's location at the end of its step.
+ * @param enemyRules The enemy's rules.
+ */
+float Bullet::contactTime(Vec2 from, Vec2 to, BulletRules* rules, Vec2 enemyFrom, Vec2 enemyTo, EnemyRules* enemyRules)
+{
+	// Solve |start + motion * t| < radius for the smallest t in [0, 1].
+	Vec2 start = from - enemyFrom;
+	Vec2 motion = (to - from) - (enemyTo - enemyFrom);
+	float radius = enemyRules->radius + rules->radius;
+	float c = start.x*start.x + start.y*start.y - radius*radius;
+	if(c < 0)
+		return 0;
+	float a = motion.x*motion.x + motion.y*motion.y;
+	float b = start.x*motion.x + start.y*motion.y;
+	if(a == 0 || b >= 0)
+		return -1;
+	float discriminant = b*b - a*c;
+	if(discriminant <= 0)
+		return -1;
+	float time = (-b - sqrt(discriminant)) / a;
+	if(time > 1)
+		return -1;
+	return time;
 }
 
 /**
- * Called by the game to render this bullet to the screen.
+ * Called by the game to record this bullet for drawing to the screen.
  */
-void Bullet::draw()
+void Bullet::render(RenderSnapshot* snapshot)
 {
-	ofPushStyle();
-	ofSetColor(BULLET_R, BULLET_G, BULLET_B, BULLET_A);
-	ofCircle(_loc.x, _loc.y, _rules->radius);
-	ofPopStyle();
+	snapshot->circle(_loc, _rules->radius, IntColor(BULLET_R, BULLET_G, BULLET_B, BULLET_A));
 }
 
 /**
@@ -80,7 +321,7 @@ BulletRules* Bullet::rules()
 /**
  * Returns the current location of this bullet.
  */
-ofPoint Bullet::loc()
+Vec2 Bullet::loc()
 {
 	return _loc;
 }
@@ -88,7 +329,7 @@ ofPoint Bullet::loc()
 /**
  * Returns the current velocity of this bullet.
  */
-ofPoint Bullet::vel()
+Vec2 Bullet::vel()
 {
 	return _vel;
 }
\ No newline at end of file
@@ -1,6 +1,11 @@
 #pragma once
 
 #include "GameObject.h"
+#include "TimerWheel.h"
+
+class Enemy;
+class CommandBuffer;
+struct EnemyRules;
 
 /**
  * Contains static rules for a particular kind of bullet.
@@ -13,26 +18,57 @@ struct BulletRules
 
 /**
  * A projectile fired from the player's ship(s).
- * Effected by real-world gravity according to the accelerometer.
+ * Effected by the game's gravity, which normally comes from the accelerometer.
  */
-class Bullet : public GameObject
+class Bullet : public GameObject, public TimerListener
 {
 private:
 	
 	BulletRules* _rules;
-	ofPoint _loc;
-	ofPoint _vel;
+	Vec2 _loc;
+	Vec2 _vel;
+	bool _predicted;
+	Enemy* _hitEnemy;
+	int _hitFrame;
+	TimerId _hitTimer;
+	bool _hitDue;
+	Vec2 _stepFrom; // The location before the latest step.
+	bool _searched; // Whether the latest step looked for an enemy to hit.
+	
+	Enemy* findHit(bool skipRemoved, int* tests);
 	
 public:
 	
-	Bullet(Game* game, BulletRules* rules, ofPoint loc, ofPoint vel);
+	Bullet(Game* game, BulletRules* rules, Vec2 loc, Vec2 vel);
+	Bullet(Game* game, Snapshot* snapshot);
+	~Bullet();
 	
 	virtual void update();
-	virtual void draw();
+	virtual void render(RenderSnapshot* snapshot);
+	
+	void advance(CommandBuffer* commands, int* tests);
+	void resolve(bool speculative, Enemy* candidate);
+	
+	GameObjectType type(){return GAMEOBJECT_BULLET;}
+	int renderItemCount(){return 1;}
+	RenderLayer renderLayer(){return RENDER_LAYER_BULLETS;}
+	void save(Snapshot* snapshot);
+	
+	void predictHit(Enemy* enemy, int frame);
+	void predictMiss();
+	void clearPrediction();
+	bool hasPrediction();
+	Enemy* predictedEnemy();
+	int predictedFrame();
+	void timerFired(int tag);
+	
+	static void step(Vec2* loc, Vec2* vel, Vec2 gravity, BulletRules* rules);
+	static bool isOffScreen(Vec2 loc, BulletRules* rules);
+	static float contactTime(Vec2 from, Vec2 to, BulletRules* rules, Vec2 enemyFrom, Vec2 enemyTo, EnemyRules* enemyRules);
 	
 	BulletRules* rules();
-	ofPoint loc();
-	ofPoint vel();
+	Vec2 loc();
+	Vec2 vel();
 	
 	bool isBullet(){return true;}
 };
\ No newline at end of file
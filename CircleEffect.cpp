@@ -1,5 +1,8 @@
 #include "CircleEffect.h"
 #include "Game.h"
+#include "Snapshot.h"
+#include "RenderSnapshot.h"
+#include "rules.h"
 
 /**
  * Creates a new CircleEffect to be placed in the game.
@@ -12,7 +15,7 @@
  * @param startRadius The initial radius of th circle.
  * @param endRadius The radius that the circle will grow/shrink to throughout its duration.
  */
-CircleEffect::CircleEffect(Game* game, int duration, ofPoint startLoc, ofPoint endLoc,
+CircleEffect::CircleEffect(Game* game, int duration, Vec2 startLoc, Vec2 endLoc,
 			 IntColor startColor, IntColor endColor, float startRadius, float endRadius)
 	: GameObject(game)
 {
@@ -24,36 +27,88 @@ CircleEffect::CircleEffect(Game* game, int duration, ofPoint startLoc, ofPoint e
 	_endColor = endColor;
 	_startRadius = startRadius;
 	_endRadius = endRadius;
+	
+	// Remove from game once enough frames have passed.
+	_expiryTimer = game->timers()->schedule(_startFrame + _duration + 1, this, 0);
 }
 
 /**
- * Called by the game to update this effect's logic.
+ * Recreates an effect from the state written by save().
  */
-void CircleEffect::update()
+CircleEffect::CircleEffect(Game* game, Snapshot* snapshot)
+	: GameObject(game)
 {
-	// Remove from game if enough frames have passed.
-	int frame = _game->frames();
-	if(frame > _startFrame + _duration)
-		_game->delayRemoveGameObject(this);
+	_startFrame = snapshot->read<int>();
+	_duration = snapshot->read<int>();
+	_startLoc = snapshot->read<Vec2>();
+	_endLoc = snapshot->read<Vec2>();
+	_startColor = snapshot->read<IntColor>();
+	_endColor = snapshot->read<IntColor>();
+	_startRadius = snapshot->read<float>();
+	_endRadius = snapshot->read<float>();
+	_expiryTimer = game->timers()->schedule(_startFrame + _duration + 1, this, 0);
+}
+
+/**
+ * Writes this effect's state to a snapshot.
+ */
+void CircleEffect::save(Snapshot* snapshot)
+{
+	snapshot->write(_startFrame);
+	snapshot->write(_duration);
+	snapshot->write(_startLoc);
+	snapshot->write(_endLoc);
+	snapshot->write(_startColor);
+	snapshot->write(_endColor);
+	snapshot->write(_startRadius);
+	snapshot->write(_endRadius);
+}
+
+/**
+ * Cancels the expiry timer if this effect is destroyed before it fires.
+ */
+CircleEffect::~CircleEffect()
+{
+	_game->timers()->cancel(_expiryTimer);
+}
+
+/**
+ * Called by the timer wheel when this effect has run its course.
+ */
+void CircleEffect::timerFired(int tag)
+{
+	_game->delayRemoveGameObject(this);
 }
 
 /**
- * Called by the game to draw this CircleEffect to the screen.
+ * Returns whether this effect is drawn at the current render quality.
+ * At lower qualities only some of the small effects, such as enemy deaths, are drawn.
  */
-void CircleEffect::draw()
+bool CircleEffect::isDrawn()
 {
+	if(max(_startRadius, _endRadius) >= QUALITY_MINOR_EFFECT_RAD)
+		return true;
+	int stride = _game->renderQuality()->minorEffectStride;
+	return stride != 0 && _addOrder % stride == 0;
+}
+
+/**
+ * Called by the game to record this CircleEffect for drawing to the screen.
+ */
+void CircleEffect::render(RenderSnapshot* snapshot)
+{
+	if(!isDrawn())
+		return;
+	
 	// Interpolate location, color, and radius from start to end.
 	int frame = _game->frames();
 	float f = (frame - _startFrame) / (float)_duration;
-	ofPoint loc = _startLoc*(1-f) + _endLoc*f;
+	Vec2 loc = _startLoc*(1-f) + _endLoc*f;
 	int r = _startColor.r()*(1-f) + _endColor.r()*f;
 	int g = _startColor.g()*(1-f) + _endColor.g()*f;
 	int b = _startColor.b()*(1-f) + _endColor.b()*f;
 	int a = _startColor.a()*(1-f) + _endColor.a()*f;
 	float rad = _startRadius*(1-f) + _endRadius*f;
 	
-	ofPushStyle();
-	ofSetColor(r, g, b, a);
-	ofCircle(loc.x, loc.y, rad);
-	ofPopStyle();
+	snapshot->circle(loc, rad, IntColor(r, g, b, a));
 }
\ No newline at end of file
@@ -2,30 +2,42 @@
 
 #include "GameObject.h"
 #include "IntColor.h"
+#include "TimerWheel.h"
 
 /**
  * A special short-lived game object that is an expanding or shrinking circle
  * that fades from one color to another. It can also move from one point to another.
  * Once it has been alive for a particular duration, it removes itself from the game.
  */
-class CircleEffect : public GameObject
+class CircleEffect : public GameObject, public TimerListener
 {
 private:
 	
+	TimerId _expiryTimer;
 	int _startFrame;
 	int _duration;
-	ofPoint _startLoc;
-	ofPoint _endLoc;
+	Vec2 _startLoc;
+	Vec2 _endLoc;
 	IntColor _startColor;
 	IntColor _endColor;
 	float _startRadius;
 	float _endRadius;
 	
+	bool isDrawn();
+	
 public:
 	
-	CircleEffect(Game* game, int duration, ofPoint startLoc, ofPoint endLoc,
+	CircleEffect(Game* game, int duration, Vec2 startLoc, Vec2 endLoc,
 				 IntColor startColor, IntColor endColor, float startRadius, float endRadius);
 	
-	virtual void update();
-	virtual void draw();
+	CircleEffect(Game* game, Snapshot* snapshot);
+	virtual ~CircleEffect();
+	
+	virtual void render(RenderSnapshot* snapshot);
+	
+	GameObjectType type(){return GAMEOBJECT_CIRCLE_EFFECT;}
+	int renderItemCount(){return isDrawn() ? 1 : 0;}
+	RenderLayer renderLayer(){return RENDER_LAYER_EFFECTS;}
+	void save(Snapshot* snapshot);
+	void timerFired(int tag);
 };
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "CommandBuffer.h"
+#include "GameObject.h"
+
+static const char* commandNames[] = {"add", "remove", "sleep", "hit"};
+
+/**
+ * Records a command that doesn't add an object.
+ */
+void CommandBuffer::append(CommandType type, int order, GameObject* object, int frame)
+{
+	_commands.push_back(Command());
+	Command& command = _commands.back();
+	command.type = type;
+	command.order = order;
+	command.object = object;
+	command.frame = frame;
+}
+
+/**
+ * Records that the specified object is to be added to the game.
+ */
+void CommandBuffer::add(int order, shared_ptr<GameObject> gobject)
+{
+	append(COMMAND_ADD, order, NULL, 0);
+	_commands.back().added = gobject;
+}
+
+/**
+ * Records that the specified object is to be removed from the game.
+ */
+void CommandBuffer::remove(int order, GameObject* gobject)
+{
+	append(COMMAND_REMOVE, order, gobject, 0);
+}
+
+/**
+ * Records that the specified enemy is to sleep until the specified frame.
+ */
+void CommandBuffer::sleep(int order, GameObject* enemy, int wakeFrame)
+{
+	append(COMMAND_SLEEP, order, enemy, wakeFrame);
+}
+
+/**
+ * Records that the specified enemy or player is hit.
+ */
+void CommandBuffer::hit(int order, GameObject* target)
+{
+	append(COMMAND_HIT, order, target, 0);
+}
+
+/**
+ * Discards every command.
+ */
+void CommandBuffer::clear()
+{
+	_commands.clear();
+}
+
+/**
+ * Returns the number of commands recorded.
+ */
+int CommandBuffer::size()
+{
+	return _commands.size();
+}
+
+/**
+ * Returns the command at the specified index, in the order recorded.
+ */
+Command* CommandBuffer::command(int index)
+{
+	return &_commands[index];
+}
+
+/**
+ * Prints every command, one per line, identifying objects by their add order.
+ */
+void CommandBuffer::print()
+{
+	vector<Command>::iterator iter;
+	for(iter = _commands.begin(); iter != _commands.end(); ++iter)
+	{
+		GameObject* object = iter->type == COMMAND_ADD ? iter->added.get() : iter->object;
+		printf("command: turn %d %s %d", iter->order, commandNames[iter->type], object->addOrder());
+		if(iter->type == COMMAND_SLEEP)
+			printf(" until %d", iter->frame);
+		printf("\n");
+	}
+}
+
+/**
+ * Orders commands by the add order of the objects that issued them.
+ */
+static bool issuedBefore(const Command& a, const Command& b)
+{
+	return a.order < b.order;
+}
+
+/**
+ * Combines the specified buffers into one ordered by the add order of the issuing objects.
+ * Commands with equal order keep the order of the buffers and, within a buffer,
+ * the order they were recorded in, so the result doesn't depend on which thread
+ * filled which buffer when.
+ */
+void CommandBuffer::merge(vector<CommandBuffer*>& buffers, CommandBuffer* merged)
+{
+	merged->clear();
+	vector<CommandBuffer*>::iterator iter;
+	for(iter = buffers.begin(); iter != buffers.end(); ++iter)
+		merged->_commands.insert(merged->_commands.end(), (*iter)->_commands.begin(), (*iter)->_commands.end());
+	stable_sort(merged->_commands.begin(), merged->_commands.end(), issuedBefore);
+}
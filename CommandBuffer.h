@@ -0,0 +1,58 @@
+#pragma once
+
+class GameObject;
+
+/**
+ * The kinds of changes to a game that are recorded rather than made on the spot.
+ */
+enum CommandType
+{
+	COMMAND_ADD, // Add a GameObject, such as a bullet or an effect, at the end of the tick.
+	COMMAND_REMOVE, // Remove a GameObject at the end of the tick.
+	COMMAND_SLEEP, // Put an enemy to sleep at the end of the tick.
+	COMMAND_HIT // Hit an enemy or a player at the issuing object's turn.
+};
+
+/**
+ * A single recorded change.
+ */
+struct Command
+{
+	CommandType type;
+	int order; // The add order of the object whose turn issued the command, or -1 if none.
+	GameObject* object; // The object removed, put to sleep, or hit. NULL for additions.
+	shared_ptr<GameObject> added; // The object added. NULL otherwise.
+	int frame; // For sleeps, the frame at which to wake.
+};
+
+/**
+ * An append-only list of commands.
+ * Each thread that updates part of a game records into a buffer of its own,
+ * so recording takes no locks; the game then merges the buffers in the order
+ * the issuing objects were added and applies them on one thread.
+ * Every change of a tick ends up in one buffer in a deterministic order,
+ * which the game can print as it applies it (see COMMAND_LOG).
+ */
+class CommandBuffer
+{
+private:
+	
+	vector<Command> _commands;
+	
+	void append(CommandType type, int order, GameObject* object, int frame);
+
+public:
+	
+	void add(int order, shared_ptr<GameObject> gobject);
+	void remove(int order, GameObject* gobject);
+	void sleep(int order, GameObject* enemy, int wakeFrame);
+	void hit(int order, GameObject* target);
+	
+	void clear();
+	int size();
+	Command* command(int index);
+	
+	void print();
+	
+	static void merge(vector<CommandBuffer*>& buffers, CommandBuffer* merged);
+};
@@ -0,0 +1,96 @@
+#include "DustField.h"
+#include "rules.h"
+#include "RenderSnapshot.h"
+
+/**
+ * Creates a field of the specified number of dust particles, all at rest in the
+ * top left corner until they are scattered.
+ */
+DustField::DustField(int count)
+	: _x(count), _y(count), _velX(count), _velY(count)
+{
+}
+
+/**
+ * Places every particle at a random whole-pixel location on the screen, at rest.
+ * @param seed The seed for the dust's random numbers. The same seed always
+ * scatters the particles the same way.
+ */
+void DustField::scatter(unsigned int seed)
+{
+	_random.setState(seed);
+	int i;
+	for(i = 0; i < count(); i++)
+	{
+		_x[i] = _random.nextInt(SCREEN_WIDTH);
+		_y[i] = _random.nextInt(SCREEN_HEIGHT);
+		_velX[i] = 0;
+		_velY[i] = 0;
+	}
+}
+
+/**
+ * Moves every particle by its velocity and then accelerates it by the specified gravity.
+ */
+void DustField::update(Vec2 gravity)
+{
+	if(count() == 0)
+		return;
+	
+	Vec2 accel = gravity * DUST_GRAVITY_FACTOR;
+	advance(&_x[0], &_velX[0], count(), accel.x, SCREEN_WIDTH);
+	advance(&_y[0], &_velY[0], count(), accel.y, SCREEN_HEIGHT);
+}
+
+/**
+ * Moves the particles along one axis, slowing them by friction, and loops any
+ * that leave the screen round to its other side.
+ * Both edges are tested before either is applied, and nothing depends on another
+ * particle, so the loop has no branches and the compiler can turn it into vector
+ * instructions.
+ * @param loc The particles' coordinates along the axis.
+ * @param vel The particles' velocities along the axis.
+ * @param accel The acceleration along the axis.
+ * @param extent The size of the screen along the axis.
+ */
+void DustField::advance(float* loc, float* vel, int count, float accel, float extent)
+{
+	float friction = DUST_FRICTION;
+	float low = -DUST_RAD;
+	float high = extent + DUST_RAD;
+	int i;
+	for(i = 0; i < count; i++)
+	{
+		float next = loc[i] + vel[i];
+		vel[i] = (vel[i] + accel) * friction;
+		bool under = next < low;
+		bool over = next > high;
+		next = under ? high : next;
+		next = over ? low : next;
+		loc[i] = next;
+	}
+}
+
+/**
+ * Records the dust for drawing to the screen as a single batch.
+ * @param stride Draw one particle in this many, always the same ones, or none if 0.
+ */
+void DustField::render(RenderSnapshot* snapshot, int stride)
+{
+	if(stride == 0 || count() == 0)
+		return;
+	
+	int drawn = (count() + stride - 1) / stride;
+	Vec2* locs = snapshot->points(drawn, DUST_RAD, IntColor(DUST_R, DUST_G, DUST_B, DUST_A));
+	int i;
+	for(i = 0; i < drawn; i++)
+		locs[i] = Vec2(_x[i * stride], _y[i * stride]);
+}
+
+/**
+ * Returns the number of particles.
+ */
+int DustField::count()
+{
+	return _x.size();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Vec2.h"
+#include "Random.h"
+
+class RenderSnapshot;
+
+/**
+ * The background dust: particles that have no effect on the gameplay but are
+ * effected by gravity and so give a subtle indication of the direction of gravity.
+ * The particles are kept as separate arrays of coordinates rather than as game
+ * objects, so updating them is one pass of plain float math over each array and
+ * drawing them is a single batch, however many there are.
+ * Dust is not part of the saved simulation state; restoring a snapshot leaves it
+ * where it is.
+ */
+class DustField
+{
+private:
+	
+	vector<float> _x;
+	vector<float> _y;
+	vector<float> _velX;
+	vector<float> _velY;
+	Random _random; // The dust's own random numbers, so it never uses up the game's.
+	
+	static void advance(float* loc, float* vel, int count, float accel, float extent);
+
+public:
+	
+	DustField(int count);
+	
+	void scatter(unsigned int seed);
+	void update(Vec2 gravity);
+	void render(RenderSnapshot* snapshot, int stride);
+	
+	int count();
+};
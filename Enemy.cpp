@@ -4,6 +4,12 @@
 #include "Player.h"
 #include "IntColor.h"
 #include "CircleEffect.h"
+#include "HitPredictor.h"
+#include "FastMath.h"
+#include "Trace.h"
+#include "Snapshot.h"
+#include "RenderSnapshot.h"
+#include "CommandBuffer.h"
 #include <float.h>
 
 /**
@@ -12,11 +18,48 @@
  * @param rules The static rules governing the behavior of this Enemy.
  * @param loc The initial location of this Enemy.
  */
-Enemy::Enemy(Game* game, EnemyRules* rules, ofPoint loc)
+Enemy::Enemy(Game* game, EnemyRules* rules, Vec2 loc)
 	: GameObject(game)
 {
 	_rules = rules;
 	_loc = loc;
+	_prevLoc = loc;
+	_asleep = false;
+	_sleepFrame = 0;
+	_sleptFrame = 0;
+	_steppedAhead = false;
+}
+
+/**
+ * Recreates an enemy from the state written by save().
+ * A sleeping enemy's wake-up timer is scheduled by the game.
+ */
+Enemy::Enemy(Game* game, Snapshot* snapshot)
+	: GameObject(game)
+{
+	_rules = snapshot->read<EnemyRules*>();
+	_loc = snapshot->read<Vec2>();
+	_prevLoc = snapshot->read<Vec2>();
+	_asleep = snapshot->read<bool>();
+	_sleepFrame = snapshot->read<int>();
+	_sleepTarget = snapshot->read<Vec2>();
+	_sleptFrame = _sleepFrame;
+	_sleptLoc = _loc;
+	_sleptPrevLoc = _prevLoc;
+	_steppedAhead = false;
+}
+
+/**
+ * Writes this enemy's state to a snapshot.
+ */
+void Enemy::save(Snapshot* snapshot)
+{
+	snapshot->write(_rules);
+	snapshot->write(_loc);
+	snapshot->write(_prevLoc);
+	snapshot->write(_asleep);
+	snapshot->write(_sleepFrame);
+	snapshot->write(_sleepTarget);
 }
 
 /**
@@ -24,14 +67,126 @@ Enemy::Enemy(Game* game, EnemyRules* rules, ofPoint loc)
  */
 void Enemy::update()
 {
-	// Find closest player.
+	CommandBuffer* commands = _game->turnCommands();
+	commands->clear();
+	steer(commands);
+	resolve(commands, 0, commands->size());
+}
+
+/**
+ * Takes this frame's step towards the closest player and records, without acting on them,
+ * a hit if the step reaches that player and a sleep if the enemy should fall asleep afterwards.
+ * Touches nothing but this enemy and the buffer, so the game may steer many enemies
+ * at once ahead of their turn in the frame.
+ */
+void Enemy::steer(CommandBuffer* commands)
+{
+	_lastPrevLoc = _prevLoc;
+	_prevLoc = _loc;
+	_steppedAhead = true;
+	
+	// If we found a closest player, move towards that player.
+	Player* closestPlayer = this->closestPlayer();
+	if(closestPlayer != NULL && !_game->isMarkedForRemoval(closestPlayer))
+	{
+		// Move towards player.
+		Vec2 vel = moveTowards(closestPlayer->loc());
+		
+		// Check for collision with player.
+		Vec2 diff = _loc - closestPlayer->loc();
+		float distSquared = diff.x*diff.x + diff.y*diff.y;
+		float collisionDist = _rules->radius + PLAYER_COLLISION_RAD;
+		if(FastMath::isEnabled() ? distSquared < collisionDist*collisionDist : sqrt(distSquared) < collisionDist)
+			commands->hit(_addOrder, closestPlayer);
+		
+		// While the players hold still, an off-screen enemy walks in a straight line
+		// and nothing can touch it, so put it to sleep until just before it could.
+		if(ENEMY_LOD && (vel.x != 0 || vel.y != 0) && _game->playersStationary())
+		{
+			int frames = framesUntilVisible(vel);
+			if(frames > ENEMY_LOD_MIN_SLEEP_FRAMES)
+			{
+				_sleepTarget = closestPlayer->loc();
+				commands->sleep(_addOrder, this, _game->frames() + frames - ENEMY_LOD_WAKE_MARGIN);
+			}
+		}
+	}
+}
+
+/**
+ * Acts on the commands recorded by the latest step, the specified range of the
+ * specified buffer: hits the player it reached and asks to fall asleep.
+ * Called at this enemy's turn in the frame. Returns whether a player was hit.
+ */
+bool Enemy::resolve(CommandBuffer* commands, int begin, int end)
+{
+	_steppedAhead = false;
+	return _game->applyTurn(commands, begin, end);
+}
+
+/**
+ * Takes back a step taken ahead of this enemy's turn and updates again,
+ * for when something the step depended on has changed since.
+ */
+void Enemy::restep()
+{
+	_loc = _prevLoc;
+	_prevLoc = _lastPrevLoc;
+	update();
+}
+
+/**
+ * Returns the step this enemy had taken by the time the object with the specified
+ * add order was updated: this frame's step if this enemy's turn came first,
+ * otherwise last frame's.
+ */
+void Enemy::stepAsOf(int addOrder, Vec2* from, Vec2* to)
+{
+	if(_steppedAhead && addOrder < _addOrder)
+	{
+		*from = _lastPrevLoc;
+		*to = _prevLoc;
+	}
+	else
+	{
+		*from = _prevLoc;
+		*to = _loc;
+	}
+}
+
+/**
+ * Moves this enemy one frame's worth of distance towards the specified location.
+ * Returns the velocity it moved with.
+ */
+Vec2 Enemy::moveTowards(Vec2 target)
+{
+	Vec2 vel = velocityTowards(_loc, target);
+	_loc += vel;
+	return vel;
+}
+
+/**
+ * Returns the velocity with which this enemy would move from one location towards another.
+ * Shared with the hit predictor so that predicted paths match exactly.
+ */
+Vec2 Enemy::velocityTowards(Vec2 from, Vec2 target)
+{
+	return FastMath::scaleTo(target - from, _rules->speed);
+}
+
+/**
+ * Returns the player closest to this enemy, which is the one it moves towards,
+ * or NULL if there are no players.
+ */
+Player* Enemy::closestPlayer()
+{
 	Player* closestPlayer = NULL;
 	float closestDistSquared = FLT_MAX;
 	vector<Player*>::iterator iter;
 	for(iter = _game->playersBegin(); iter != _game->playersEnd(); iter++)
 	{
 		Player* player = *iter;
-		ofPoint diff = player->loc() - _loc;
+		Vec2 diff = player->loc() - _loc;
 		float distSquared = diff.x*diff.x + diff.y*diff.y;
 		if(distSquared < closestDistSquared)
 		{
@@ -39,37 +194,53 @@ void Enemy::update()
 			closestDistSquared = distSquared;
 		}
 	}
+	return closestPlayer;
+}
+
+/**
+ * Returns the number of frames until this enemy, moving at the specified velocity,
+ * could first be hit by a bullet or touch a player, or -1 if it never could.
+ * Players are never closer than PLAYER_COLLISION_RAD to the edge of the screen
+ * so the screen is expanded by that much.
+ */
+int Enemy::framesUntilVisible(Vec2 vel)
+{
+	float pad = _rules->radius + PLAYER_COLLISION_RAD;
+	float lo[2] = {-pad, -pad};
+	float hi[2] = {SCREEN_WIDTH + pad, SCREEN_HEIGHT + pad};
+	float loc[2] = {_loc.x, _loc.y};
+	float v[2] = {vel.x, vel.y};
 	
-	// If we found a closest player, move towards that player.
-	if(closestPlayer != NULL && !_game->isMarkedForRemoval(closestPlayer))
+	// Intersect the ray with the expanded screen rectangle one axis at a time.
+	float tEnter = 0;
+	float tExit = FLT_MAX;
+	int i;
+	for(i = 0; i < 2; i++)
 	{
-		// Move towards player.
-		ofPoint diff = closestPlayer->loc() - _loc;
-		float length = sqrt(diff.x*diff.x + diff.y*diff.y);
-		if(length > 0)
+		if(v[i] == 0)
 		{
-			ofPoint normalized = diff / length;
-			ofPoint vel = normalized * _rules->speed;
-			_loc += vel;
+			if(loc[i] < lo[i] || loc[i] > hi[i])
+				return -1;
+			continue;
 		}
 		
-		// Check for collision with player.
-		diff = _loc - closestPlayer->loc();
-		length = sqrt(diff.x*diff.x + diff.y*diff.y);
-		if(length < _rules->radius + PLAYER_COLLISION_RAD)
-			closestPlayer->hit();
+		float t1 = (lo[i] - loc[i]) / v[i];
+		float t2 = (hi[i] - loc[i]) / v[i];
+		tEnter = max(tEnter, min(t1, t2));
+		tExit = min(tExit, max(t1, t2));
 	}
+	
+	if(tEnter > tExit)
+		return -1;
+	return (int)tEnter;
 }
 
 /**
- * Called by the game to render this Enemy to the screen.
+ * Called by the game to record this Enemy for drawing to the screen.
  */
-void Enemy::draw()
+void Enemy::render(RenderSnapshot* snapshot)
 {
-	ofPushStyle();
-	ofSetColor(ENEMY_R, ENEMY_G, ENEMY_B, ENEMY_A);
-	ofCircle(_loc.x, _loc.y, _rules->radius);
-	ofPopStyle();
+	snapshot->circle(_loc, _rules->radius, IntColor(ENEMY_R, ENEMY_G, ENEMY_B, ENEMY_A));
 }
 
 /**
@@ -88,7 +259,9 @@ void Enemy::hit()
  */
 void Enemy::kill()
 {
+	TRACE_INSTANT("enemy killed");
 	_game->delayRemoveGameObject(this);
+	_game->predictor()->enemyKilled(this);
 	
 	// Create death effect.
 	IntColor startColor(ENEMY_DEATH_R, ENEMY_DEATH_G, ENEMY_DEATH_B, ENEMY_DEATH_A);
@@ -105,16 +278,97 @@ void Enemy::kill()
 	_game->delayAddGameObject(shared_ptr<CircleEffect>(effect));
 }
 
+/**
+ * Called by the game when this enemy is taken out of the update loop.
+ * The enemy keeps walking towards where the player it was targeting stood.
+ */
+void Enemy::sleep()
+{
+	_asleep = true;
+	_sleepFrame = _game->frames();
+	_sleptFrame = _sleepFrame;
+	_sleptLoc = _loc;
+	_sleptPrevLoc = _prevLoc;
+}
+
+/**
+ * Called by the game when this enemy rejoins the update loop.
+ * @param frame The last frame that has been simulated. The enemy is moved to
+ * where it would have been at the end of that frame.
+ */
+void Enemy::wake(int frame)
+{
+	_loc = sleptLoc(frame, &_prevLoc);
+	_asleep = false;
+}
+
+/**
+ * Returns where this sleeping enemy is at the end of the specified frame.
+ * The frames slept are replayed with the same steps update() would have taken, so the
+ * location is bit-for-bit what it would have been awake. The replay picks up from the
+ * latest frame asked for, so a sleeper costs a few operations per frame slept however
+ * often it is asked, where staying awake would have cost a full update every frame.
+ * @param prevLoc Set to the location at the start of that frame.
+ */
+Vec2 Enemy::sleptLoc(int frame, Vec2* prevLoc)
+{
+	if(frame < _sleptFrame)
+	{
+		_sleptFrame = _sleepFrame;
+		_sleptLoc = _loc;
+		_sleptPrevLoc = _prevLoc;
+	}
+	for(; _sleptFrame < frame; _sleptFrame++)
+	{
+		_sleptPrevLoc = _sleptLoc;
+		_sleptLoc += velocityTowards(_sleptLoc, _sleepTarget);
+	}
+	*prevLoc = _sleptPrevLoc;
+	return _sleptLoc;
+}
+
+/**
+ * Called by the timer wheel when it is time for this enemy to wake up.
+ */
+void Enemy::timerFired(int tag)
+{
+	_game->delayWakeEnemy(this);
+}
+
+/**
+ * Returns whether this enemy is currently asleep.
+ */
+bool Enemy::isAsleep()
+{
+	return _asleep;
+}
+
+/**
+ * Returns where the player this sleeping enemy walks towards stood when it fell asleep.
+ */
+Vec2 Enemy::sleepTarget()
+{
+	return _sleepTarget;
+}
+
 /**
  * Returns whether this enemy is currently on the screen.
  * Enemies off the screen cannot be hit by the player's bullets.
  */
 bool Enemy::isOnScreen()
 {
-	return _loc.x + _rules->radius > 0 &&
-	       _loc.x - _rules->radius < SCREEN_WIDTH &&
-	       _loc.y + _rules->radius > 0 &&
-	       _loc.y - _rules->radius < SCREEN_HEIGHT;
+	return isOnScreen(_loc);
+}
+
+/**
+ * Returns whether this enemy would be on the screen at the specified location.
+ */
+bool Enemy::isOnScreen(Vec2 loc)
+{
+	return loc.x + _rules->radius > 0 &&
+	       loc.x - _rules->radius < SCREEN_WIDTH &&
+	       loc.y + _rules->radius > 0 &&
+	       loc.y - _rules->radius < SCREEN_HEIGHT;
 }
 
 /**
@@ -128,7 +382,21 @@ EnemyRules* Enemy::rules()
 /**
  * Returns the current location of this Enemy.
  */
-ofPoint Enemy::loc()
+Vec2 Enemy::loc()
 {
+	if(_asleep)
+	{
+		Vec2 prevLoc;
+		return sleptLoc(_game->frames(), &prevLoc);
+	}
 	return _loc;
+}
+
+/**
+ * Returns the location of this Enemy at the start of its most recent update.
+ * Bullets sweep against the enemy's motion between the two locations.
+ */
+Vec2 Enemy::prevLoc()
+{
+	return _prevLoc;
 }
\ No newline at end of file
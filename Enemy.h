@@ -1,6 +1,10 @@
 #pragma once
 
 #include "GameObject.h"
+#include "TimerWheel.h"
+
+class Player;
+class CommandBuffer;
 
 /**
  * Contains static rules for a particular kind of enemy.
@@ -15,26 +19,60 @@ struct EnemyRules
  * An enemy blob that continuously advances towards the player.
  * If it hits the player, the player is killed.
  */
-class Enemy : public GameObject
+class Enemy : public GameObject, public TimerListener
 {
 private:
 	
 	EnemyRules* _rules;
-	ofPoint _loc;
+	Vec2 _loc;
+	Vec2 _prevLoc;
+	bool _asleep;
+	int _sleepFrame;
+	Vec2 _sleepTarget;
+	int _sleptFrame; // The latest frame replayed while asleep, so that asking again is free.
+	Vec2 _sleptLoc; // The location at the end of that frame.
+	Vec2 _sleptPrevLoc; // The location at the start of that frame.
+	Vec2 _lastPrevLoc; // The previous location before the latest step.
+	bool _steppedAhead; // Whether the latest step was taken ahead of this enemy's turn in the frame.
+	
+	Vec2 moveTowards(Vec2 target);
+	int framesUntilVisible(Vec2 vel);
+	Vec2 sleptLoc(int frame, Vec2* prevLoc);
 	
 public:
 	
-	Enemy(Game* game, EnemyRules* rules, ofPoint loc);
+	Enemy(Game* game, EnemyRules* rules, Vec2 loc);
+	Enemy(Game* game, Snapshot* snapshot);
 	
 	void update();
-	void draw();
+	void render(RenderSnapshot* snapshot);
+	
+	void steer(CommandBuffer* commands);
+	bool resolve(CommandBuffer* commands, int begin, int end);
+	void restep();
+	void stepAsOf(int addOrder, Vec2* from, Vec2* to);
+	
+	GameObjectType type(){return GAMEOBJECT_ENEMY;}
+	int renderItemCount(){return 1;}
+	RenderLayer renderLayer(){return RENDER_LAYER_ENEMIES;}
+	void save(Snapshot* snapshot);
 	
 	void hit();
 	void kill();
 	
+	void sleep();
+	void wake(int frame);
+	bool isAsleep();
+	Vec2 sleepTarget();
+	void timerFired(int tag);
+	
+	Player* closestPlayer();
+	Vec2 velocityTowards(Vec2 from, Vec2 target);
 	bool isOnScreen();
+	bool isOnScreen(Vec2 loc);
 	EnemyRules* rules();
-	ofPoint loc();
+	Vec2 loc();
+	Vec2 prevLoc();
 	
 	bool isEnemy(){return true;}
 };
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "FastMath.h"
+#include "rules.h"
+#include <string.h>
+
+// The sine table covers one full turn, plus one entry so interpolation never wraps.
+#define SIN_TABLE_SIZE 1024
+#define SIN_TABLE_MASK (SIN_TABLE_SIZE - 1)
+
+static float sinTable[SIN_TABLE_SIZE + 1];
+
+/**
+ * Fills the sine table. Called once, during static initialization.
+ */
+static bool buildSinTable()
+{
+	int i;
+	for(i = 0; i <= SIN_TABLE_SIZE; i++)
+		sinTable[i] = sin(i * TWO_PI / SIN_TABLE_SIZE);
+	return true;
+}
+static bool sinTableBuilt = buildSinTable();
+
+bool FastMath::_enabled = FAST_MATH;
+
+/**
+ * Selects the fast (true) or accurate (false) versions of every function.
+ */
+void FastMath::setEnabled(bool enabled)
+{
+	_enabled = enabled;
+}
+
+/**
+ * Returns whether the fast versions are selected.
+ */
+bool FastMath::isEnabled()
+{
+	return _enabled;
+}
+
+/**
+ * Computes the sine and cosine of an angle in radians.
+ * The fast version linearly interpolates a table; the cosine is read a quarter
+ * turn further along. The angle is reduced in double precision so that large
+ * angles, such as a spinning player's accumulated rotation, stay accurate.
+ */
+void FastMath::sinCos(float rad, float* sinOut, float* cosOut)
+{
+	if(!_enabled)
+	{
+		*sinOut = sin(rad);
+		*cosOut = cos(rad);
+		return;
+	}
+	
+	double t = rad * (SIN_TABLE_SIZE / TWO_PI);
+	double whole = floor(t);
+	float frac = t - whole;
+	int i = (int)whole & SIN_TABLE_MASK;
+	int j = (i + SIN_TABLE_SIZE / 4) & SIN_TABLE_MASK;
+	*sinOut = sinTable[i] + (sinTable[i + 1] - sinTable[i]) * frac;
+	*cosOut = sinTable[j] + (sinTable[j + 1] - sinTable[j]) * frac;
+}
+
+/**
+ * Computes the sines and cosines of an array of angles in radians. See sinCos.
+ */
+void FastMath::sinCosBatch(const float* rad, float* sinOut, float* cosOut, int count)
+{
+	int i;
+	for(i = 0; i < count; i++)
+		sinCos(rad[i], &sinOut[i], &cosOut[i]);
+}
+
+/**
+ * Returns the reciprocal of the square root of a positive number.
+ * The fast version refines the classic bit-level estimate with two Newton steps.
+ */
+float FastMath::rsqrt(float x)
+{
+	if(!_enabled)
+		return 1 / sqrt(x);
+	
+	unsigned int bits;
+	memcpy(&bits, &x, sizeof(bits));
+	bits = 0x5f3759df - (bits >> 1);
+	float y;
+	memcpy(&y, &bits, sizeof(y));
+	float halfX = 0.5f * x;
+	y = y * (1.5f - halfX * y * y);
+	y = y * (1.5f - halfX * y * y);
+	return y;
+}
+
+/**
+ * Computes the reciprocal square roots of an array of positive numbers. See rsqrt.
+ */
+void FastMath::rsqrtBatch(const float* x, float* out, int count)
+{
+	int i;
+	for(i = 0; i < count; i++)
+		out[i] = rsqrt(x[i]);
+}
+
+/**
+ * Rotates a vector clockwise on screen by an angle in degrees.
+ */
+Vec2 FastMath::rotate(Vec2 v, float deg)
+{
+	float rad = ofDegToRad(deg);
+	float sinRot;
+	float cosRot;
+	sinCos(rad, &sinRot, &cosRot);
+	return Vec2(
+		v.x * cosRot - v.y * sinRot,
+		v.x * sinRot + v.y * cosRot);
+}
+
+/**
+ * Returns a vector in the same direction as the specified one with the specified length,
+ * or the zero vector if the specified one has no direction.
+ * The fast version multiplies by rsqrt instead of taking a square root and dividing.
+ */
+Vec2 FastMath::scaleTo(Vec2 v, float length)
+{
+	float lengthSquared = v.x*v.x + v.y*v.y;
+	if(_enabled)
+	{
+		if(lengthSquared > 0)
+			return v * (rsqrt(lengthSquared) * length);
+		return Vec2();
+	}
+	
+	float vLength = sqrt(lengthSquared);
+	if(vLength > 0)
+	{
+		Vec2 normalized = v / vLength;
+		return normalized * length;
+	}
+	return Vec2();
+}
\ No newline at end of file
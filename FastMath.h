@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Vec2.h"
+
+/**
+ * Approximate trig and square root kernels for the simulation's hot spots,
+ * each with an accurate counterpart selected by a single switch.
+ * With the switch off every function computes exactly what the libm version would,
+ * so the fast versions can be benchmarked against the accurate ones per level.
+ *
+ * Maximum errors of the fast versions:
+ * - sinCos: 4.8e-6 absolute, for angles within +/-1e4 radians.
+ *   Larger angles lose precision before they get here, as with sin and cos.
+ * - rsqrt: 4.7e-6 relative, for any positive normal float.
+ */
+class FastMath
+{
+private:
+	
+	static bool _enabled;
+	
+public:
+	
+	static void setEnabled(bool enabled);
+	static bool isEnabled();
+	
+	static void sinCos(float rad, float* sinOut, float* cosOut);
+	static void sinCosBatch(const float* rad, float* sinOut, float* cosOut, int count);
+	static float rsqrt(float x);
+	static void rsqrtBatch(const float* x, float* out, int count);
+	
+	static Vec2 rotate(Vec2 v, float deg);
+	static Vec2 scaleTo(Vec2 v, float length);
+};
\ No newline at end of file
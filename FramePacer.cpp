@@ -0,0 +1,118 @@
+#include "FramePacer.h"
+#include "Stopwatch.h"
+#include "rules.h"
+
+/**
+ * Creates a pacer at the full rate.
+ */
+FramePacer::FramePacer()
+{
+	_tier = PACE_FULL;
+	_quietFrames = 0;
+	_stillFrames = 0;
+	_tierStartMicros = Stopwatch::nowMicros();
+	int i;
+	for(i = 0; i < PACE_TIER_COUNT; i++)
+		_tierMicros[i] = 0;
+}
+
+/**
+ * Called after each frame is drawn with what changed since the previous frame
+ * drawn, summed over the simulation's ticks in between.
+ * Any item outside the dust moving, appearing, or disappearing goes straight
+ * back to the full rate; the rate only drops once frames have been quiet, with
+ * nothing but dust moving and colors fading, for PACE_REDUCE_FRAMES, or
+ * completely still for PACE_IDLE_FRAMES.
+ * @param changes The number of items that changed.
+ * @param moves The number of those that were items outside the dust moving, appearing, or disappearing.
+ */
+void FramePacer::drew(int changes, int moves)
+{
+	if(moves > 0)
+	{
+		_quietFrames = 0;
+		_stillFrames = 0;
+		setTier(PACE_FULL);
+		return;
+	}
+	
+	_quietFrames++;
+	_stillFrames = changes == 0 ? _stillFrames + 1 : 0;
+	if(_stillFrames >= PACE_IDLE_FRAMES)
+		setTier(PACE_IDLE);
+	else if(_quietFrames >= PACE_REDUCE_FRAMES)
+		setTier(PACE_REDUCED);
+	else
+		setTier(PACE_FULL);
+}
+
+/**
+ * Goes straight back to the full rate, as on a touch.
+ */
+void FramePacer::wake()
+{
+	_quietFrames = 0;
+	_stillFrames = 0;
+	setTier(PACE_FULL);
+}
+
+/**
+ * Changes the rate Open Frameworks draws at, if the tier is different,
+ * adding the time spent in the old tier to its total.
+ */
+void FramePacer::setTier(PaceTier tier)
+{
+	if(tier == _tier)
+		return;
+	long long now = Stopwatch::nowMicros();
+	_tierMicros[_tier] += now - _tierStartMicros;
+	_tierStartMicros = now;
+	_tier = tier;
+	ofSetFrameRate(rate(tier));
+}
+
+/**
+ * Returns the current tier.
+ */
+PaceTier FramePacer::tier()
+{
+	return _tier;
+}
+
+/**
+ * Returns the total time spent in the specified tier, including the current stretch.
+ */
+long long FramePacer::tierMicros(PaceTier tier)
+{
+	long long micros = _tierMicros[tier];
+	if(tier == _tier)
+		micros += Stopwatch::nowMicros() - _tierStartMicros;
+	return micros;
+}
+
+/**
+ * Prints the time spent in each tier.
+ */
+void FramePacer::print()
+{
+	printf("pacing: full %.1fs, reduced %.1fs, idle %.1fs\n",
+		   tierMicros(PACE_FULL) / 1000000.0f,
+		   tierMicros(PACE_REDUCED) / 1000000.0f,
+		   tierMicros(PACE_IDLE) / 1000000.0f);
+}
+
+/**
+ * Returns the frames per second drawn in the specified tier.
+ */
+int FramePacer::rate(PaceTier tier)
+{
+	switch(tier)
+	{
+		case PACE_REDUCED:
+			return PACE_REDUCED_RATE;
+		case PACE_IDLE:
+			return PACE_IDLE_RATE;
+		default:
+			return PACE_FULL_RATE;
+	}
+}
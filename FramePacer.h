@@ -0,0 +1,45 @@
+#pragma once
+
+/**
+ * The rates at which a FramePacer can present frames, fastest first.
+ */
+enum PaceTier
+{
+	PACE_FULL, // Something is moving or was just touched.
+	PACE_REDUCED, // Only dust and colors have changed for a while, such as text fading.
+	PACE_IDLE, // Nothing has changed for a while, or there's nothing to show.
+	PACE_TIER_COUNT
+};
+
+/**
+ * Lowers the rate the main thread draws at while the frames it draws barely
+ * change, to save power, and raises it again as soon as they change or the
+ * screen is touched. Only used while the simulation runs on its own thread,
+ * since that keeps ticking at its own rate however often frames are drawn.
+ * Keeps track of how long was spent at each rate.
+ */
+class FramePacer
+{
+private:
+	
+	PaceTier _tier;
+	int _quietFrames; // Frames drawn in a row with only dust moving.
+	int _stillFrames; // Frames drawn in a row with no changes.
+	long long _tierStartMicros;
+	long long _tierMicros[PACE_TIER_COUNT];
+	
+	void setTier(PaceTier tier);
+
+public:
+	
+	FramePacer();
+	
+	void drew(int changes, int moves);
+	void wake();
+	
+	PaceTier tier();
+	long long tierMicros(PaceTier tier);
+	void print();
+	
+	static int rate(PaceTier tier);
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+/**
+ * Per-frame instrumentation counters collected by the Game.
+ * Each counter is overwritten by the update or draw that measures it.
+ */
+struct FrameStats
+{
+	long long updateMicros; // Time spent in Game::update, including collision.
+	long long collisionMicros; // Time spent testing bullets against enemies.
+	long long drawMicros; // Time spent in Game::render, recording the frame for drawing.
+	int collisionTests; // Number of bullet/enemy pairs tested.
+	long long inputAgeMicros; // Age of the newest accelerometer sample behind this frame's gravity.
+	int qualityLevel; // The QualityScaler level the frame was recorded at.
+	int objectsAdded; // Number of GameObjects added to the game during the update.
+};
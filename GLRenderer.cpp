@@ -0,0 +1,329 @@
+#include "GLRenderer.h"
+#include "RenderSnapshot.h"
+#include "App.h"
+#include "rules.h"
+#include <math.h>
+
+/**
+ * Creates a renderer that draws with the specified application's fonts.
+ */
+GLRenderer::GLRenderer(App* app)
+	: Renderer(SCREEN_WIDTH, SCREEN_HEIGHT)
+{
+	_app = app;
+	_fillCircles = true;
+	_discTexture = 0;
+	_ringTexture = 0;
+	_maxPointSize = 0;
+	_pixelScale = 1;
+}
+
+/**
+ * Starts a frame. The screen has already been cleared by Open Frameworks.
+ * The circle textures are made before the first frame, once there's a GL context.
+ */
+void GLRenderer::begin()
+{
+	Renderer::begin();
+	ofPushStyle();
+	
+	if(SDF_CIRCLES && _discTexture == 0)
+	{
+		makeCircleTexture(&_discTexture, true);
+		makeCircleTexture(&_ringTexture, false);
+		
+		GLfloat pointSizes[2];
+		glGetFloatv(GL_ALIASED_POINT_SIZE_RANGE, pointSizes);
+		_maxPointSize = pointSizes[1];
+	}
+}
+
+/**
+ * Creates a texture holding how much of each texel a circle covers, in alpha,
+ * with a full chain of mipmaps each worked out exactly rather than filtered down.
+ * The circle reaches CIRCLE_TEXTURE_FILL of the way from the center to the edge,
+ * leaving room for its anti-aliased edge.
+ * @param filled Whether the circle is filled or only a one-texel outline.
+ */
+void GLRenderer::makeCircleTexture(GLuint* texture, bool filled)
+{
+	glGenTextures(1, texture);
+	glBindTexture(GL_TEXTURE_2D, *texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	
+	vector<unsigned char> alpha(CIRCLE_TEXTURE_SIZE * CIRCLE_TEXTURE_SIZE);
+	int level = 0;
+	int size;
+	for(size = CIRCLE_TEXTURE_SIZE; size >= 1; size /= 2)
+	{
+		float center = size / 2.0f;
+		float radius = center * CIRCLE_TEXTURE_FILL;
+		int x;
+		int y;
+		for(y = 0; y < size; y++)
+		{
+			for(x = 0; x < size; x++)
+			{
+				float dx = x + 0.5f - center;
+				float dy = y + 0.5f - center;
+				float coverage = circleCoverage(sqrt(dx*dx + dy*dy), radius, filled);
+				alpha[y*size + x] = (unsigned char)(coverage * 255 + 0.5f);
+			}
+		}
+		glTexImage2D(GL_TEXTURE_2D, level, GL_ALPHA, size, size, 0, GL_ALPHA, GL_UNSIGNED_BYTE, &alpha[0]);
+		level++;
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+/**
+ * Finishes a frame, restoring the style it started with.
+ */
+void GLRenderer::end()
+{
+	ofPopStyle();
+}
+
+/**
+ * Sets the current color.
+ */
+void GLRenderer::applyColor(IntColor color)
+{
+	_color = color;
+	ofSetColor(color.r(), color.g(), color.b(), color.a());
+}
+
+/**
+ * Sets the current fill mode.
+ */
+void GLRenderer::applyFilled(bool filled)
+{
+	_fillCircles = filled;
+	if(filled)
+		ofFill();
+	else
+		ofNoFill();
+}
+
+/**
+ * Draws a circle as one textured quad, tinted the current color, or as a mesh
+ * if it's bigger on the screen than the texture's circle.
+ */
+void GLRenderer::circle(Vec2 loc, float radius)
+{
+	_stats.primitives++;
+	if(!SDF_CIRCLES)
+	{
+		ofCircle(loc.x, loc.y, radius);
+		return;
+	}
+	if(radius * _pixelScale > CIRCLE_TEXTURE_SIZE / 2 * CIRCLE_TEXTURE_FILL)
+	{
+		meshCircle(loc, radius);
+		return;
+	}
+	
+	float half = radius / CIRCLE_TEXTURE_FILL;
+	GLfloat vertices[] = {
+		loc.x - half, loc.y - half,
+		loc.x + half, loc.y - half,
+		loc.x - half, loc.y + half,
+		loc.x + half, loc.y + half};
+	static const GLfloat texCoords[] = {0, 0, 1, 0, 0, 1, 1, 1};
+	
+	glEnable(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, _fillCircles ? _discTexture : _ringTexture);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glVertexPointer(2, GL_FLOAT, 0, vertices);
+	glTexCoordPointer(2, GL_FLOAT, 0, texCoords);
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glDisable(GL_TEXTURE_2D);
+}
+
+/**
+ * Draws a circle as rings of triangles whose vertices carry the coverage
+ * circleCoverage gives at their distance from the center, tinted the current color.
+ * Across the edge, coverage changes linearly with distance, as the GPU blends it
+ * between vertices, so the edge is a pixel wide whatever the radius. The edge is
+ * split into enough pieces that none strays from the true circle by more than
+ * CIRCLE_MESH_TOLERANCE of a pixel.
+ */
+void GLRenderer::meshCircle(Vec2 loc, float radius)
+{
+	float pixelRadius = radius * _pixelScale;
+	int segments = (int)ceil(PI / acos(1 - CIRCLE_MESH_TOLERANCE / pixelRadius));
+	
+	// The distances, in pixels, between which coverage changes linearly.
+	float edges[3];
+	if(_fillCircles)
+	{
+		edges[0] = 0;
+		edges[1] = pixelRadius - 0.5f;
+		edges[2] = pixelRadius + 0.5f;
+	}
+	else
+	{
+		edges[0] = pixelRadius - 1;
+		edges[1] = pixelRadius;
+		edges[2] = pixelRadius + 1;
+	}
+	
+	int i;
+	for(i = 0; i < 2; i++)
+	{
+		annulus(loc, edges[i] / _pixelScale, edges[i + 1] / _pixelScale,
+				circleCoverage(edges[i], pixelRadius, _fillCircles),
+				circleCoverage(edges[i + 1], pixelRadius, _fillCircles),
+				segments);
+	}
+	
+	// The current color is undefined after drawing with a color array.
+	applyColor(_color);
+}
+
+/**
+ * Draws the ring between two radii as a strip of triangles, tinted the current
+ * color with its alpha scaled by the specified coverage at either radius.
+ * @param segments The number of pieces the ring is split into around the circle.
+ */
+void GLRenderer::annulus(Vec2 loc, float inner, float outer, float innerCoverage, float outerCoverage, int segments)
+{
+	int vertexCount = (segments + 1) * 2;
+	_meshVertices.resize(vertexCount * 2);
+	_meshColors.resize(vertexCount * 4);
+	GLubyte innerAlpha = (GLubyte)(_color.a() * innerCoverage + 0.5f);
+	GLubyte outerAlpha = (GLubyte)(_color.a() * outerCoverage + 0.5f);
+	int i;
+	for(i = 0; i <= segments; i++)
+	{
+		float rad = i * TWO_PI / segments;
+		float x = cos(rad);
+		float y = sin(rad);
+		GLfloat* vertices = &_meshVertices[i * 4];
+		vertices[0] = loc.x + x * inner;
+		vertices[1] = loc.y + y * inner;
+		vertices[2] = loc.x + x * outer;
+		vertices[3] = loc.y + y * outer;
+		
+		GLubyte* colors = &_meshColors[i * 8];
+		colors[0] = colors[4] = _color.r();
+		colors[1] = colors[5] = _color.g();
+		colors[2] = colors[6] = _color.b();
+		colors[3] = innerAlpha;
+		colors[7] = outerAlpha;
+	}
+	
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glVertexPointer(2, GL_FLOAT, 0, &_meshVertices[0]);
+	glColorPointer(4, GL_UNSIGNED_BYTE, 0, &_meshColors[0]);
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, vertexCount);
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+/**
+ * Draws a line.
+ */
+void GLRenderer::line(Vec2 start, Vec2 end)
+{
+	ofLine(start.x, start.y, end.x, end.y);
+	_stats.primitives++;
+}
+
+/**
+ * Draws a filled triangle. The fill mode must be filled.
+ */
+void GLRenderer::triangle(Vec2 a, Vec2 b, Vec2 c)
+{
+	ofTriangle(a.x, a.y, b.x, b.y, c.x, c.y);
+	_stats.primitives++;
+}
+
+/**
+ * Fills the whole screen with the current color in a single quad.
+ */
+void GLRenderer::fill()
+{
+	ofRect(0, 0, _width, _height);
+	_stats.primitives++;
+}
+
+/**
+ * Draws a batch of filled circles as point sprites textured like single circles,
+ * in one call. Sprites are sized in pixels rather than points, so batches too big
+ * for the GPU to draw as sprites are drawn a circle at a time instead.
+ * The GPU drops a sprite whose center is off the target, so the few circles that
+ * hang over the edge from outside it are drawn as quads afterwards.
+ */
+void GLRenderer::points(const Vec2* locs, int count, float radius)
+{
+	float half = radius / CIRCLE_TEXTURE_FILL;
+	float size = half * 2 * _pixelScale;
+	if(!POINT_SPRITES || !SDF_CIRCLES || size > _maxPointSize)
+	{
+		Renderer::points(locs, count, radius);
+		return;
+	}
+	
+	glEnable(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, _discTexture);
+	glEnable(GL_POINT_SPRITE_OES);
+	glTexEnvi(GL_POINT_SPRITE_OES, GL_COORD_REPLACE_OES, GL_TRUE);
+	glPointSize(size);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(2, GL_FLOAT, sizeof(Vec2), locs);
+	glDrawArrays(GL_POINTS, 0, count);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glDisable(GL_POINT_SPRITE_OES);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glDisable(GL_TEXTURE_2D);
+	_stats.primitives++;
+	
+	int i;
+	for(i = 0; i < count; i++)
+	{
+		Vec2 loc = locs[i];
+		bool outside = loc.x < 0 || loc.y < 0 || loc.x > _width || loc.y > _height;
+		if(outside && loc.x > -half && loc.y > -half && loc.x < _width + half && loc.y < _height + half)
+			circle(loc, radius);
+	}
+}
+
+/**
+ * Sets how many pixels of the target being drawn to there are to a point along
+ * each axis, for sizing point sprites. Defaults to 1.
+ */
+void GLRenderer::setPixelScale(float scale)
+{
+	_pixelScale = scale;
+}
+
+/**
+ * Draws a string in one of the application's fonts.
+ */
+void GLRenderer::text(const RenderText& text)
+{
+	ofTrueTypeFont* font = text.font == RENDER_FONT_BIG ? _app->fontBig() : _app->fontSmall();
+	float xOffset = 0;
+	float yOffset = 0;
+	if(text.centered)
+	{
+		xOffset = -font->stringWidth(text.text)/2;
+		yOffset = -font->stringHeight(text.text)/2 + font->getLineHeight()*text.lineOffset;
+	}
+	ofPushMatrix();
+	ofTranslate(text.loc.x, text.loc.y);
+	ofRotateZ(text.deg);
+	ofTranslate(xOffset, yOffset);
+	font->drawString(text.text, 0, 0);
+	ofPopMatrix();
+	_stats.primitives++;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Renderer.h"
+
+class App;
+
+/**
+ * Draws to the screen with Open Frameworks' immediate-mode calls.
+ * Must be used on the thread that owns the GL context.
+ * Circles are drawn as single quads textured with their coverage, so drawing one
+ * costs the same four vertices whatever its radius. OpenGL ES 1.1 has no fragment
+ * shaders to work the coverage out per pixel, so it is worked out ahead of time
+ * for every mipmap level instead, each with its own one-texel edge. The level the
+ * GPU picks for a circle then has an edge about a pixel wide on the screen.
+ * Circles bigger on the screen than the texture's own would be magnified and
+ * blurred, so they're drawn as meshes that carry the coverage at their vertices instead.
+ * Batches of circles are drawn as point sprites with the same texture, all in one call.
+ */
+class GLRenderer : public Renderer
+{
+private:
+	
+	App* _app;
+	IntColor _color; // The current color.
+	bool _fillCircles; // The current fill mode.
+	GLuint _discTexture;
+	GLuint _ringTexture;
+	float _maxPointSize; // The largest point sprite the GPU draws, in pixels.
+	float _pixelScale; // The pixels per point of the target being drawn to.
+	vector<GLfloat> _meshVertices;
+	vector<GLubyte> _meshColors;
+	
+	static void makeCircleTexture(GLuint* texture, bool filled);
+	void meshCircle(Vec2 loc, float radius);
+	void annulus(Vec2 loc, float inner, float outer, float innerCoverage, float outerCoverage, int segments);
+
+protected:
+	
+	void applyColor(IntColor color);
+	void applyFilled(bool filled);
+
+public:
+	
+	GLRenderer(App* app);
+	
+	void begin();
+	void end();
+	
+	void circle(Vec2 loc, float radius);
+	void line(Vec2 start, Vec2 end);
+	void triangle(Vec2 a, Vec2 b, Vec2 c);
+	void text(const RenderText& text);
+	void fill();
+	void points(const Vec2* locs, int count, float radius);
+	
+	void setPixelScale(float scale);
+};
@@ -8,34 +8,49 @@
 #include "Player.h"
 #include "Bullet.h"
 #include "Enemy.h"
-#include "Dust.h"
+#include "Stopwatch.h"
+#include "FastMath.h"
+#include "Trace.h"
+#include <string.h>
 
 /**
  * Constructs a new Game object, initializing it to the specified level object.
  * The level's populateGame() method will be called to populate the
  * actual GameObjects in this Game.
- * @param app The main application object.
+ * @param app The main application object, or NULL for a headless game that is
+ * only ever updated, never drawn, and stays on its level when it ends.
  * @param level The object used to initialize the contents of this Game object.
+ * @param seed The seed for the game's random numbers, or 0 to pick one at random.
  */
-Game::Game(App* app, shared_ptr<LevelBase> level)
+Game::Game(App* app, shared_ptr<LevelBase> level, unsigned int seed)
+	: _predictor(this), _random(seed != 0 ? seed : rand()), _rewind(REWIND_SNAPSHOT_COUNT), _dust(DUST_COUNT)
 {
 	_app = app;	
 	_level = level;
+	_gravityPolicy = shared_ptr<GravityPolicy>(new AccelerometerGravity());
+	_updatePool = NULL;
+	_renderPool = NULL;
+	_renderQuality = QualityScaler::quality(0);
+	_turnOrder = -1;
 	_frames = 0;
+	_pendingSpawnWaves = 0;
+	_playersStationary = false;
+	_playersChanged = false;
+	_nextAddOrder = 0;
+	_retryDue = false;
 	_resetAtFrame = -1;
 	_nextAtFrame = -1;
 	_winAtFrame = -1;
 	_loseAtFrame = -1;
+	_resetTimer = 0;
+	_nextTimer = 0;
+	_winTimer = 0;
+	_loseTimer = 0;
+	memset(&_stats, 0, sizeof(_stats));
 	
-	// Create dust.
-	int i;
-	for(i = 0; i < DUST_COUNT; i++)
-	{
-		int x = rand() % SCREEN_WIDTH;
-		int y = rand() % SCREEN_HEIGHT;
-		Dust* dust = new Dust(this, ofPoint(x, y), ofPoint(0, 0));
-		addGameObject(shared_ptr<Dust>(dust));
-	}
+	// Create dust, from a seed of its own so the gameplay's random numbers are
+	// the same however much dust there is.
+	_dust.scatter(_random.state() ^ DUST_SEED_MIX);
 	
 	// Populate game. This will callback to this Game object's various methods.
 	_level->populateGame(this);
@@ -51,13 +66,27 @@ Game::Game(App* app, shared_ptr<LevelBase> level)
 		color,
 		LEVEL_INTRO_RAD,
 		0);
-	delayAddGameObject(shared_ptr<CircleEffect>(effect));
+	addGameObject(shared_ptr<CircleEffect>(effect));
+	
+	// Keep the starting state so the level can be retried without rebuilding it.
+	saveSnapshot(&_startSnapshot);
 }
 
 /**
  * Immediately adds the specified GameObject to the game.
  */
 void Game::addGameObject(shared_ptr<GameObject> gobject)
+{
+	_stats.objectsAdded++;
+	gobject->setAddOrder(_nextAddOrder++);
+	insertGameObject(gobject);
+}
+
+/**
+ * Puts the specified GameObject at the end of the GameObjects list and the appropriate
+ * type-specific list, keeping the order in which it was originally added.
+ */
+void Game::insertGameObject(shared_ptr<GameObject> gobject)
 {
 	_gobjects.push_back(gobject);
 	
@@ -73,7 +102,10 @@ void Game::addGameObject(shared_ptr<GameObject> gobject)
 	
 	Enemy* asEnemy = dynamic_cast<Enemy*>(gobject.get());
 	if(asEnemy != NULL)
+	{
 		_enemies.push_back(asEnemy);
+		_predictor.enemyArrived(asEnemy);
+	}
 }
 
 /**
@@ -81,7 +113,7 @@ void Game::addGameObject(shared_ptr<GameObject> gobject)
  */
 void Game::delayAddGameObject(shared_ptr<GameObject> gobject)
 {
-	_gobjectsToAdd.push_back(gobject);
+	_commands.add(_turnOrder, gobject);
 }
 
 /**
@@ -96,6 +128,7 @@ void Game::removeGameObject(GameObject* gobject)
 	{
 		vector<Player*>::iterator found = find(_players.begin(), _players.end(), asPlayer);
 		_players.erase(found);
+		_playersChanged = true;
 	}
 	
 	Bullet* asBullet = dynamic_cast<Bullet*>(gobject);
@@ -128,7 +161,8 @@ void Game::removeGameObject(GameObject* gobject)
  */
 void Game::delayRemoveGameObject(GameObject* gobject)
 {
-	_gobjectsToRemove.push_back(gobject);
+	gobject->markForRemoval();
+	_commands.remove(_turnOrder, gobject);
 }
 
 /**
@@ -136,13 +170,289 @@ void Game::delayRemoveGameObject(GameObject* gobject)
  */
 bool Game::isMarkedForRemoval(GameObject* gobject)
 {
-	vector<GameObject*>::iterator iter;
-	for(iter = _gobjectsToRemove.begin(); iter != _gobjectsToRemove.end(); ++iter)
+	return gobject->isMarkedForRemoval();
+}
+
+/**
+ * Hits the specified enemy or player on behalf of the object being updated,
+ * recording the hit in the current tick's commands.
+ */
+void Game::hitObject(GameObject* target)
+{
+	_commands.hit(_turnOrder, target);
+	target->hit();
+}
+
+/**
+ * Carries out the hits and sleeps recorded by the object being updated,
+ * the specified range of the specified buffer, in the order they were recorded.
+ * Returns whether anything was hit.
+ */
+bool Game::applyTurn(CommandBuffer* commands, int begin, int end)
+{
+	bool hit = false;
+	int i;
+	for(i = begin; i < end; i++)
+	{
+		Command* command = commands->command(i);
+		if(command->type == COMMAND_HIT)
+		{
+			hitObject(command->object);
+			hit = true;
+		}
+		else if(command->type == COMMAND_SLEEP)
+		{
+			delaySleepEnemy(static_cast<Enemy*>(command->object), command->frame);
+		}
+	}
+	return hit;
+}
+
+/**
+ * Returns the buffer an enemy updated in turn records its step into.
+ * The enemy clears it before use.
+ */
+CommandBuffer* Game::turnCommands()
+{
+	return &_turnCommands;
+}
+
+/**
+ * Schedules a wave of enemies to enter the game at the start of the wave's frame.
+ * Waves that are already due are spawned immediately.
+ */
+void Game::scheduleSpawn(const SpawnWave& wave)
+{
+	if(wave.frame <= _frames)
+	{
+		spawn(wave);
+		return;
+	}
+	
+	_timers.schedule(wave.frame, this, GAME_TIMER_SPAWN + _spawnWaves.size());
+	_spawnWaves.push_back(wave);
+	_pendingSpawnWaves++;
+}
+
+/**
+ * Immediately adds the enemies of the specified wave to the game.
+ */
+void Game::spawn(const SpawnWave& wave)
+{
+	TRACE_INSTANT("spawn");
+	// Pick every enemy's angle and distance, then place them all at once.
+	vector<float> rads(wave.count);
+	vector<int> dists(wave.count);
+	int i;
+	for(i = 0; i < wave.count; i++)
+	{
+		int deg = wave.minDeg;
+		if(wave.maxDeg > wave.minDeg)
+			deg += _random.nextInt(wave.maxDeg - wave.minDeg);
+		rads[i] = ofDegToRad(deg);
+		int dist = wave.minDist;
+		if(wave.maxDist > wave.minDist)
+			dist += _random.nextInt(wave.maxDist - wave.minDist);
+		dists[i] = dist;
+	}
+	
+	vector<float> sins(wave.count);
+	vector<float> coses(wave.count);
+	if(wave.count > 0 && FastMath::isEnabled())
+		FastMath::sinCosBatch(&rads[0], &sins[0], &coses[0], wave.count);
+	
+	for(i = 0; i < wave.count; i++)
+	{
+		// The accurate path computes each offset with the same expression, in the same
+		// precision, as enemies were always placed, so spawns match bit for bit.
+		Vec2 offset;
+		if(FastMath::isEnabled())
+			offset = Vec2(dists[i] * coses[i], dists[i] * sins[i]);
+		else
+			offset = Vec2(dists[i] * cos(rads[i]), dists[i] * sin(rads[i]));
+		Enemy* enemy = new Enemy(this, wave.enemyRules, offset + SCREEN_CENTER);
+		addGameObject(shared_ptr<Enemy>(enemy));
+	}
+}
+
+/**
+ * Returns the number of waves scheduled to spawn but not yet in the game.
+ */
+int Game::pendingSpawnCount()
+{
+	return _pendingSpawnWaves;
+}
+
+/**
+ * Compares GameObjects and enemies by the order in which they were added to the game.
+ */
+static bool addedBefore(const shared_ptr<GameObject>& a, const shared_ptr<GameObject>& b)
+{
+	return a->addOrder() < b->addOrder();
+}
+static bool enemyAddedBefore(Enemy* a, Enemy* b)
+{
+	return a->addOrder() < b->addOrder();
+}
+
+/**
+ * Takes the specified enemy out of the update loop at the end of the current frame
+ * until the start of the specified frame.
+ * Must be called from the enemy's own update so that enemies are queued in update order.
+ */
+void Game::delaySleepEnemy(Enemy* enemy, int wakeFrame)
+{
+	_commands.sleep(_turnOrder, enemy, wakeFrame);
+}
+
+/**
+ * Returns the specified sleeping enemy to the update loop once the current timers have fired.
+ * Called when the enemy's wake timer fires.
+ */
+void Game::delayWakeEnemy(Enemy* enemy)
+{
+	_enemiesToWake.push_back(enemy);
+}
+
+/**
+ * Moves the enemies queued by delaySleepEnemy out of the GameObjects and Enemies lists.
+ * The queue is in the same order as both lists, so this is a single pass over each.
+ */
+void Game::sleepEnemies()
+{
+	if(_enemiesToSleep.empty())
+		return;
+	
+	// Remove from the Enemies list, putting each enemy to sleep.
+	int queueSize = _enemiesToSleep.size();
+	int queued = 0;
+	int kept = 0;
+	int i;
+	for(i = 0; i < (int)_enemies.size(); i++)
+	{
+		Enemy* enemy = _enemies[i];
+		if(queued < queueSize && enemy == _enemiesToSleep[queued].enemy)
+		{
+			queued++;
+			if(!isMarkedForRemoval(enemy))
+			{
+				enemy->sleep();
+				continue;
+			}
+		}
+		_enemies[kept++] = enemy;
+	}
+	_enemies.resize(kept);
+	
+	// Move from the GameObjects list to the sleeping list.
+	queued = 0;
+	kept = 0;
+	for(i = 0; i < (int)_gobjects.size(); i++)
+	{
+		if(queued < queueSize && _gobjects[i].get() == _enemiesToSleep[queued].enemy)
+		{
+			SleepingEnemy& sleeping = _enemiesToSleep[queued];
+			queued++;
+			if(sleeping.enemy->isAsleep())
+			{
+				sleeping.gobject = _gobjects[i];
+				sleeping.wakeTimer = _timers.schedule(sleeping.wakeFrame, sleeping.enemy, 0);
+				_sleepingEnemies[sleeping.enemy] = sleeping;
+				continue;
+			}
+		}
+		_gobjects[kept++] = _gobjects[i];
+	}
+	_gobjects.resize(kept);
+	
+	_enemiesToSleep.clear();
+}
+
+/**
+ * Returns the specified sleeping enemies to the GameObjects and Enemies lists
+ * at their original positions.
+ * @param enemies The enemies to wake. Sorted in place.
+ * @param lastFrame The last frame that has been simulated. Woken enemies are moved
+ * to where they would have been at the end of that frame.
+ */
+void Game::wakeEnemies(vector<Enemy*>& enemies, int lastFrame)
+{
+	if(enemies.empty())
+		return;
+	
+	sort(enemies.begin(), enemies.end(), enemyAddedBefore);
+	
+	int oldGameObjectCount = _gobjects.size();
+	int oldEnemyCount = _enemies.size();
+	vector<Enemy*>::iterator iter;
+	for(iter = enemies.begin(); iter != enemies.end(); ++iter)
+	{
+		map<Enemy*, SleepingEnemy>::iterator found = _sleepingEnemies.find(*iter);
+		_timers.cancel(found->second.wakeTimer);
+		(*iter)->wake(lastFrameWalked(*iter, lastFrame));
+		_gobjects.push_back(found->second.gobject);
+		_enemies.push_back(*iter);
+		_predictor.enemyArrived(*iter);
+		_sleepingEnemies.erase(found);
+	}
+	inplace_merge(_gobjects.begin(), _gobjects.begin() + oldGameObjectCount, _gobjects.end(), addedBefore);
+	inplace_merge(_enemies.begin(), _enemies.begin() + oldEnemyCount, _enemies.end(), enemyAddedBefore);
+}
+
+/**
+ * Returns the last frame the specified sleeping enemy walked through, up to the specified one.
+ * Awake, an enemy stands still once the player it chases is marked for removal, so a
+ * sleeper chasing a player removed on an earlier turn of the current frame did not take
+ * this frame's step.
+ */
+int Game::lastFrameWalked(Enemy* enemy, int lastFrame)
+{
+	if(lastFrame != _frames)
+		return lastFrame;
+	vector<RemovedPlayer>::iterator iter;
+	for(iter = _removedPlayers.begin(); iter != _removedPlayers.end(); ++iter)
 	{
-		if(*iter == gobject)
-			return true;
+		if(iter->order < enemy->addOrder() && iter->loc == enemy->sleepTarget())
+			return lastFrame - 1;
 	}
-	return false;
+	return lastFrame;
+}
+
+/**
+ * Wakes every sleeping enemy. See wakeEnemies.
+ */
+void Game::wakeAllEnemies(int lastFrame)
+{
+	vector<Enemy*> enemies;
+	map<Enemy*, SleepingEnemy>::iterator iter;
+	for(iter = _sleepingEnemies.begin(); iter != _sleepingEnemies.end(); ++iter)
+		enemies.push_back(iter->first);
+	wakeEnemies(enemies, lastFrame);
+}
+
+/**
+ * Returns whether every player was stationary at the start of the current frame,
+ * in which case off-screen enemies move in straight lines.
+ */
+bool Game::playersStationary()
+{
+	return _playersStationary;
+}
+
+/**
+ * Returns the number of enemies in the game, including sleeping ones.
+ */
+int Game::enemyCount()
+{
+	return _enemies.size() + _sleepingEnemies.size();
+}
+
+/**
+ * Returns the number of enemies in the game that are awake, and so updated every frame.
+ */
+int Game::awakeEnemyCount()
+{
+	return _enemies.size();
 }
 
 /**
@@ -210,14 +520,440 @@ vector<Enemy*>::iterator Game::enemiesEnd()
 }
 
 /**
- * Called when this Game object becomes the active application state.
+ * Returns whether the objects can be updated in phases with the same results as
+ * updating them one at a time. Phases update the players first, which is only
+ * the same if every player was added before every other kind of object.
+ */
+bool Game::canUpdateInPhases()
+{
+	if(_players.empty())
+		return true;
+	int lastPlayerOrder = _players.back()->addOrder();
+	GameObjectIter iter;
+	for(iter = _gobjects.begin(); iter != _gobjects.end(); ++iter)
+	{
+		if((*iter)->type() != GAMEOBJECT_PLAYER)
+			return (*iter)->addOrder() > lastPlayerOrder;
+	}
+	return true;
+}
+
+/**
+ * Updates the game objects in phases, running the expensive parts on the update pool.
+ * The players go first, since everything else depends on where they are this frame.
+ * Then the enemies steer, all at once, and then the bullets move
+ * and find what they would hit, all at once. Nothing in those phases touches anything
+ * but the object being updated. Finally, every object acts on its results in the order
+ * the objects were added, exactly as if each had been updated in turn.
+ * Results are taken on speculation that nothing they depend on changed before the
+ * object's turn. The only thing that can is a player being hit, which changes the
+ * course of every enemy after it, so from then on the rest of the frame is redone in turn.
+ * Each chunk records its hits and sleeps into the command buffer of its job; the buffers
+ * are merged by add order, so each object finds its own commands at its turn.
+ */
+void Game::updateInPhases()
+{
+	vector<Player*>::iterator playerIter;
+	for(playerIter = _players.begin(); playerIter != _players.end(); ++playerIter)
+	{
+		_turnOrder = (*playerIter)->addOrder();
+		(*playerIter)->update();
+	}
+	_turnOrder = -1;
+	
+	int steerChunks = runUpdatePhase(UPDATE_PHASE_STEER, _gobjects.size(), _steerJobs);
+	Stopwatch collisionStopwatch;
+	int bulletChunks = runUpdatePhase(UPDATE_PHASE_BULLETS, _bullets.size(), _bulletJobs);
+	_stats.collisionMicros += collisionStopwatch.elapsedMicros();
+	
+	_phaseBuffers.clear();
+	int i;
+	for(i = 0; i < steerChunks; i++)
+		_phaseBuffers.push_back(_steerJobs[i].commands());
+	for(i = 0; i < bulletChunks; i++)
+		_phaseBuffers.push_back(_bulletJobs[i].commands());
+	CommandBuffer::merge(_phaseBuffers, &_phaseCommands);
+	
+	bool speculative = true;
+	int next = 0;
+	long long bulletsSince = -1;
+	GameObjectIter iter;
+	for(iter = _gobjects.begin(); iter != _gobjects.end(); ++iter)
+	{
+		GameObject* gobject = iter->get();
+		timeBulletRun(gobject, &bulletsSince);
+		_turnOrder = gobject->addOrder();
+		int begin = next;
+		while(next < _phaseCommands.size() && _phaseCommands.command(next)->order == _turnOrder)
+			next++;
+		
+		switch(gobject->type())
+		{
+			case GAMEOBJECT_PLAYER:
+				break;
+			case GAMEOBJECT_ENEMY:
+				if(speculative)
+				{
+					if(static_cast<Enemy*>(gobject)->resolve(&_phaseCommands, begin, next))
+						speculative = false;
+				}
+				else
+				{
+					static_cast<Enemy*>(gobject)->restep();
+				}
+				break;
+			case GAMEOBJECT_BULLET:
+			{
+				Enemy* candidate = NULL;
+				if(begin < next)
+					candidate = static_cast<Enemy*>(_phaseCommands.command(begin)->object);
+				static_cast<Bullet*>(gobject)->resolve(speculative, candidate);
+				break;
+			}
+			default:
+				gobject->update();
+				break;
+		}
+	}
+	timeBulletRun(NULL, &bulletsSince);
+	_turnOrder = -1;
+}
+
+/**
+ * Counts the time bullets spend on their turns, when they test for hits, as collision time.
+ * Called before each object's turn, and with NULL once every object has had its turn.
+ * The clock is only read where a run of bullets in add order starts or ends, rather than
+ * around every bullet, so timing costs little and adds little to what it measures.
+ * @param since When the current run of bullets started, or -1 if the latest turn wasn't a bullet's.
+ */
+void Game::timeBulletRun(GameObject* gobject, long long* since)
+{
+	bool bullet = gobject != NULL && gobject->type() == GAMEOBJECT_BULLET;
+	if(bullet == (*since >= 0))
+		return;
+	
+	long long now = Stopwatch::nowMicros();
+	if(bullet)
+	{
+		*since = now;
+	}
+	else
+	{
+		_stats.collisionMicros += now - *since;
+		*since = -1;
+	}
+}
+
+/**
+ * Runs one phase of the frame over the specified number of objects,
+ * split into chunks on the update pool, and waits for it to finish.
+ * @param jobs The jobs to run the chunks with, grown as needed.
+ * Each keeps the commands its chunk recorded until the phase runs again.
+ * Returns the number of chunks.
+ */
+int Game::runUpdatePhase(UpdatePhase phase, int count, vector<UpdateJob>& jobs)
+{
+	int chunkCount = (count + UPDATE_CHUNK_SIZE - 1) / UPDATE_CHUNK_SIZE;
+	if((int)jobs.size() < chunkCount)
+		jobs.resize(chunkCount);
+	
+	int i;
+	for(i = 0; i < chunkCount; i++)
+	{
+		jobs[i].setup(this, phase, i * UPDATE_CHUNK_SIZE, min(count, (i + 1) * UPDATE_CHUNK_SIZE));
+		_updatePool->submit(&jobs[i]);
+	}
+	_updatePool->wait();
+	
+	for(i = 0; i < chunkCount; i++)
+		_stats.collisionTests += jobs[i].collisionTests();
+	return chunkCount;
+}
+
+/**
+ * Carries out the adds, sleeps, and removals recorded during the current tick,
+ * in the order they were recorded, and starts a new list for the next tick.
+ * Hits have already been carried out; they are only recorded for the log.
+ * With COMMAND_LOG on, prints the tick's commands once the added objects have
+ * their add order, so that a tick rerun from a snapshot can be compared with the original.
+ */
+void Game::applyCommands()
+{
+	// Add any game objects delayed for addition and collect the sleeps and removals.
+	int i;
+	for(i = 0; i < _commands.size(); i++)
+	{
+		Command* command = _commands.command(i);
+		if(command->type == COMMAND_ADD)
+		{
+			addGameObject(command->added);
+		}
+		else if(command->type == COMMAND_SLEEP)
+		{
+			SleepingEnemy sleeping;
+			sleeping.wakeFrame = command->frame;
+			sleeping.enemy = static_cast<Enemy*>(command->object);
+			_enemiesToSleep.push_back(sleeping);
+		}
+		else if(command->type == COMMAND_REMOVE)
+		{
+			_gobjectsToRemove.push_back(command->object);
+			if(command->object->type() == GAMEOBJECT_PLAYER)
+			{
+				RemovedPlayer removed;
+				removed.loc = static_cast<Player*>(command->object)->loc();
+				removed.order = command->order;
+				_removedPlayers.push_back(removed);
+			}
+		}
+	}
+	if(COMMAND_LOG && _commands.size() > 0)
+	{
+		printf("commands: frame %d\n", _frames);
+		_commands.print();
+	}
+	_commands.clear();
+	
+	// Put to sleep any enemies that asked to, then remove any game objects delayed for removal.
+	sleepEnemies();
+	GameObjectPtrIter iter;
+	for(iter = _gobjectsToRemove.begin(); iter != _gobjectsToRemove.end(); ++iter)
+		removeGameObject(*iter);
+	_gobjectsToRemove.clear();
+}
+
+/**
+ * Writes the whole simulation state to the specified snapshot, replacing its contents.
+ * Timers are not written; they are rebuilt from the state when the snapshot is restored.
+ * Nor is the dust, which doesn't effect the gameplay.
+ * Must be called between frames.
+ */
+void Game::saveSnapshot(Snapshot* snapshot)
+{
+	snapshot->clear();
+	snapshot->write(_frames);
+	snapshot->write(_random.state());
+	snapshot->write(_nextAddOrder);
+	snapshot->write(_pendingSpawnWaves);
+	snapshot->write(_resetAtFrame);
+	snapshot->write(_nextAtFrame);
+	snapshot->write(_winAtFrame);
+	snapshot->write(_loseAtFrame);
+	snapshot->write(_playersStationary);
+	
+	int waveCount = _spawnWaves.size();
+	snapshot->write(waveCount);
+	int i;
+	for(i = 0; i < waveCount; i++)
+		snapshot->write(_spawnWaves[i]);
+	
+	int gobjectCount = _gobjects.size();
+	snapshot->write(gobjectCount);
+	GameObjectIter iter;
+	for(iter = _gobjects.begin(); iter != _gobjects.end(); ++iter)
+	{
+		snapshot->write((*iter)->type());
+		snapshot->write((*iter)->addOrder());
+		(*iter)->save(snapshot);
+	}
+	
+	int sleepingCount = _sleepingEnemies.size();
+	snapshot->write(sleepingCount);
+	map<Enemy*, SleepingEnemy>::iterator sleepingIter;
+	for(sleepingIter = _sleepingEnemies.begin(); sleepingIter != _sleepingEnemies.end(); ++sleepingIter)
+	{
+		snapshot->write(sleepingIter->second.wakeFrame);
+		snapshot->write(sleepingIter->first->addOrder());
+		sleepingIter->first->save(snapshot);
+	}
+}
+
+/**
+ * Replaces the whole simulation state with the contents of the specified snapshot,
+ * which must have been saved by this game. Must be called between frames.
+ */
+void Game::restoreSnapshot(Snapshot* snapshot)
+{
+	_gobjects.clear();
+	_commands.clear();
+	_gobjectsToRemove.clear();
+	_players.clear();
+	_bullets.clear();
+	_enemies.clear();
+	_sleepingEnemies.clear();
+	_enemiesToSleep.clear();
+	_enemiesToWake.clear();
+	_removedPlayers.clear();
+	_spawnWaves.clear();
+	
+	snapshot->beginRead();
+	_frames = snapshot->read<int>();
+	_random.setState(snapshot->read<unsigned int>());
+	_nextAddOrder = snapshot->read<int>();
+	_pendingSpawnWaves = snapshot->read<int>();
+	_resetAtFrame = snapshot->read<int>();
+	_nextAtFrame = snapshot->read<int>();
+	_winAtFrame = snapshot->read<int>();
+	_loseAtFrame = snapshot->read<int>();
+	_playersStationary = snapshot->read<bool>();
+	_playersChanged = false;
+	_retryDue = false;
+	
+	// Start over with no timers; the objects reschedule their own as they are recreated.
+	_timers.reset(_frames);
+	_predictor.reset();
+	_resetTimer = 0;
+	_nextTimer = 0;
+	_winTimer = 0;
+	_loseTimer = 0;
+	
+	int waveCount = snapshot->read<int>();
+	int i;
+	for(i = 0; i < waveCount; i++)
+		_spawnWaves.push_back(snapshot->read<SpawnWave>());
+	
+	int gobjectCount = snapshot->read<int>();
+	for(i = 0; i < gobjectCount; i++)
+	{
+		GameObjectType type = snapshot->read<GameObjectType>();
+		int addOrder = snapshot->read<int>();
+		shared_ptr<GameObject> gobject = createGameObject(type, snapshot);
+		gobject->setAddOrder(addOrder);
+		insertGameObject(gobject);
+	}
+	
+	int sleepingCount = snapshot->read<int>();
+	for(i = 0; i < sleepingCount; i++)
+	{
+		SleepingEnemy sleeping;
+		sleeping.wakeFrame = snapshot->read<int>();
+		int addOrder = snapshot->read<int>();
+		sleeping.enemy = new Enemy(this, snapshot);
+		sleeping.enemy->setAddOrder(addOrder);
+		sleeping.gobject = shared_ptr<Enemy>(sleeping.enemy);
+		sleeping.wakeTimer = _timers.schedule(sleeping.wakeFrame, sleeping.enemy, 0);
+		_sleepingEnemies[sleeping.enemy] = sleeping;
+	}
+	
+	// Reschedule the waves and events still to come.
+	for(i = 0; i < waveCount; i++)
+	{
+		if(_spawnWaves[i].frame > _frames)
+			_timers.schedule(_spawnWaves[i].frame, this, GAME_TIMER_SPAWN + i);
+	}
+	if(_resetAtFrame > _frames)
+		scheduleEvent(&_resetTimer, _resetAtFrame, GAME_TIMER_RESET);
+	if(_nextAtFrame > _frames)
+		scheduleEvent(&_nextTimer, _nextAtFrame, GAME_TIMER_NEXT);
+	if(_winAtFrame > _frames)
+		scheduleEvent(&_winTimer, _winAtFrame, GAME_TIMER_WIN);
+	if(_loseAtFrame > _frames)
+		scheduleEvent(&_loseTimer, _loseAtFrame, GAME_TIMER_LOSE);
+}
+
+/**
+ * Creates a GameObject of the specified type from the next state in the specified snapshot.
+ */
+shared_ptr<GameObject> Game::createGameObject(GameObjectType type, Snapshot* snapshot)
+{
+	switch(type)
+	{
+		case GAMEOBJECT_PLAYER:
+			return shared_ptr<Player>(new Player(this, snapshot));
+		case GAMEOBJECT_BULLET:
+			return shared_ptr<Bullet>(new Bullet(this, snapshot));
+		case GAMEOBJECT_ENEMY:
+			return shared_ptr<Enemy>(new Enemy(this, snapshot));
+		case GAMEOBJECT_CIRCLE_EFFECT:
+			return shared_ptr<CircleEffect>(new CircleEffect(this, snapshot));
+		default:
+			return shared_ptr<GameObject>();
+	}
+}
+
+/**
+ * Restarts the level from the snapshot taken when it was created,
+ * without rebuilding the level or reloading anything.
  */
-void Game::activate()
+void Game::retry()
 {
-	// Setup Open Frameworks for this state.
-	ofBackground(0, 0, 0);
-	ofSetBackgroundAuto(true);
-	ofSetFrameRate(60);
+	TRACE_INSTANT("retry");
+	_rewind.clear();
+	restoreSnapshot(&_startSnapshot);
+}
+
+/**
+ * Steps the game back the specified number of rewind snapshots.
+ * Rewind snapshots are only captured when REWIND_DEBUG is set.
+ * Returns false, leaving the game as it is, if not enough have been captured.
+ */
+bool Game::rewind(int snapshots)
+{
+	if(!_rewind.rewind(snapshots, &_rewindSnapshot))
+		return false;
+	restoreSnapshot(&_rewindSnapshot);
+	return true;
+}
+
+/**
+ * Replaces the source of the game's gravity, which is the accelerometer by default.
+ */
+void Game::setGravityPolicy(shared_ptr<GravityPolicy> policy)
+{
+	_gravityPolicy = policy;
+}
+
+/**
+ * Selects the thread pool on which to update the game objects, or NULL to update
+ * them one at a time on the calling thread. Either way the results are identical.
+ * The pool must not be used by anything else while the game is updating.
+ */
+void Game::setUpdatePool(ThreadPool* pool)
+{
+	_updatePool = pool;
+}
+
+/**
+ * Returns the thread pool on which the game objects are updated, or NULL.
+ */
+ThreadPool* Game::updatePool()
+{
+	return _updatePool;
+}
+
+/**
+ * Selects the thread pool on which to record the game objects for drawing, or
+ * NULL to record them one at a time on the calling thread. Either way the
+ * snapshot is identical. The pool may be the update pool, since the game
+ * never updates and records at once.
+ */
+void Game::setRenderPool(ThreadPool* pool)
+{
+	_renderPool = pool;
+}
+
+/**
+ * Returns the gravity acceleration for the current frame.
+ */
+Vec2 Game::gravity()
+{
+	return _gravity;
+}
+
+/**
+ * Returns whether the game has been won: the win effect has started.
+ */
+bool Game::isWon()
+{
+	return _winAtFrame >= 0 && _frames >= _winAtFrame;
+}
+
+/**
+ * Returns whether the game has been lost: the lose effect has started.
+ */
+bool Game::isLost()
+{
+	return _loseAtFrame >= 0 && _frames >= _loseAtFrame;
 }
 
 /**
@@ -225,51 +961,118 @@ void Game::activate()
  */
 void Game::update()
 {
+	TRACE_SCOPE("Game::update");
+	Stopwatch stopwatch;
+	_stats.collisionMicros = 0;
+	_stats.collisionTests = 0;
+	_stats.objectsAdded = 0;
+	
 	_frames++;
+	_gravity = _gravityPolicy->gravity(_frames);
+	_stats.inputAgeMicros = _gravityPolicy->inputAgeMicros();
+	
+	// If the players started moving since the enemies fell asleep,
+	// their straight-line paths no longer hold, so wake them all.
+	_playersStationary = !_players.empty();
+	vector<Player*>::iterator playerIter;
+	for(playerIter = _players.begin(); playerIter != _players.end(); ++playerIter)
+		_playersStationary = _playersStationary && (*playerIter)->isStationary();
+	if(!_playersStationary && !_sleepingEnemies.empty())
+		wakeAllEnemies(_frames - 1);
+	
+	// Fire the timers due this frame: spawns, enemy wake-ups, effect expiry,
+	// player firing, and level transitions.
+	TRACE_BEGIN("timers");
+	_timers.advance(_frames);
+	wakeEnemies(_enemiesToWake, _frames - 1);
+	_enemiesToWake.clear();
+	TRACE_END("timers");
+	
+	// Predict bullet hits now that every enemy that enters the game this frame is here.
+	TRACE_BEGIN("predict");
+	Stopwatch predictStopwatch;
+	_predictor.refresh();
+	_stats.collisionMicros += predictStopwatch.elapsedMicros();
+	TRACE_END("predict");
+	
+	// Move the dust, which nothing else depends on.
+	TRACE_BEGIN("dust");
+	_dust.update(_gravity);
+	TRACE_END("dust");
 	
 	// Update all game objects.
+	TRACE_BEGIN("objects");
 	GameObjectIter iter;
-	for(iter = _gobjects.begin(); iter != _gobjects.end(); ++iter)
-		(*iter)->update();
+	if(_updatePool != NULL && canUpdateInPhases())
+	{
+		updateInPhases();
+	}
+	else
+	{
+		long long bulletsSince = -1;
+		for(iter = _gobjects.begin(); iter != _gobjects.end(); ++iter)
+		{
+			timeBulletRun(iter->get(), &bulletsSince);
+			_turnOrder = (*iter)->addOrder();
+			(*iter)->update();
+		}
+		timeBulletRun(NULL, &bulletsSince);
+		_turnOrder = -1;
+	}
+	TRACE_END("objects");
 	
-	// Add any game objects delayed for addition.
-	for(iter = _gobjectsToAdd.begin(); iter != _gobjectsToAdd.end(); ++iter)
-		addGameObject(*iter);
-	_gobjectsToAdd.clear();
+	// Add, put to sleep, and remove the game objects recorded this tick.
+	TRACE_BEGIN("commands");
+	applyCommands();
+	TRACE_END("commands");
 	
-	// Remove any game objects delayed for removal.
-	GameObjectPtrIter iter2;
-	for(iter2 = _gobjectsToRemove.begin(); iter2 != _gobjectsToRemove.end(); ++iter2)
-		removeGameObject(*iter2);
-	_gobjectsToRemove.clear();
+	// If a player left the game, sleeping enemies may now target someone else.
+	if(_playersChanged)
+	{
+		wakeAllEnemies(_frames);
+		_playersChanged = false;
+	}
+	_removedPlayers.clear();
 	
 	// Winning, losing, resetting, and moving to the next
-	// level are detected and then scheduled to happen at
-	// a certain frame in the future.
-	// Check here to see if that future frame is now.
-	if(_frames == _winAtFrame)
-		win();
-	if(_frames == _loseAtFrame)
-		lose();
-	if(_frames == _resetAtFrame)
-		_app->resetLevel();
-	if(_frames == _nextAtFrame)
-		_app->nextLevel();
-	
-	// Detect win condition (no enemies left) and if so schedule a win.
-	if(_enemies.size() == 0 && _winAtFrame < 0 && _loseAtFrame < 0)
+	// level are detected and then scheduled on the timer
+	// wheel to happen at a certain frame in the future.
+	
+	// Detect win condition (no enemies left or still to come) and if so schedule a win.
+	if(enemyCount() == 0 && _pendingSpawnWaves == 0 && _winAtFrame < 0 && _loseAtFrame < 0)
 		winAtFrame(_frames + LEVEL_WIN_DELAY);
 	
 	// Detect lose condition (no player ships left) and if so schedule a loss.
 	if(_players.size() == 0 && _loseAtFrame < 0 && _winAtFrame < 0)
 		loseAtFrame(_frames + LEVEL_LOSE_DELAY);
+	
+	// Keep the last few seconds of snapshots for rewinding while debugging.
+	if(REWIND_DEBUG && _frames % REWIND_CAPTURE_INTERVAL == 0)
+	{
+		saveSnapshot(&_rewindSnapshot);
+		_rewind.push(&_rewindSnapshot);
+	}
+	
+	// Retry the level once the lose effect is complete.
+	if(_retryDue)
+		retry();
+	
+	_stats.updateMicros = stopwatch.elapsedMicros();
 }
 
 /**
- * Called by the application to render the game to the screen.
+ * Called by the application to record the game for drawing to the screen.
+ * Runs on the simulation thread; the snapshot is drawn later on the main thread.
  */
-void Game::draw()
+void Game::render(RenderSnapshot* snapshot)
 {
+	TRACE_SCOPE("Game::render");
+	Stopwatch stopwatch;
+	snapshot->setFrame(_frames);
+	_stats.qualityLevel = _app ? _app->qualityLevel() : 0;
+	_renderQuality = QualityScaler::quality(_stats.qualityLevel);
+	snapshot->setLayer(RENDER_LAYER_BACKGROUND);
+	
 	// Draw instructions.
 	const char* instr = _level->instructions(this);
 	if(instr != NULL)
@@ -279,43 +1082,43 @@ void Game::draw()
 		float scaledFloatAlpha = floatAlpha * LEVEL_INSTRUCTIONS_A / 255;
 		int intAlpha = scaledFloatAlpha * 255;
 		
-		float width = _app->fontSmall()->stringWidth(instr);
-		float height = _app->fontSmall()->stringHeight(instr);
-		float xOffset = -width/2;
-		float yOffset = -height/2 + _app->fontSmall()->getLineHeight()/2;
-		
-		ofPushStyle();
-		ofPushMatrix();
-		ofTranslate(LEVEL_INSTRUCTIONS_X, LEVEL_INSTRUCTIONS_Y);
-		ofRotateZ(_level->levelTextRot(this));
-		ofTranslate(xOffset, yOffset);
-		ofSetColor(LEVEL_INSTRUCTIONS_R, LEVEL_INSTRUCTIONS_G, LEVEL_INSTRUCTIONS_B, intAlpha);
-		_app->fontSmall()->drawString(instr, 0, 0);
-		ofPopMatrix();
-		ofPopStyle();
+		IntColor color(LEVEL_INSTRUCTIONS_R, LEVEL_INSTRUCTIONS_G, LEVEL_INSTRUCTIONS_B, intAlpha);
+		snapshot->text(instr, RENDER_FONT_SMALL, Vec2(LEVEL_INSTRUCTIONS_X, LEVEL_INSTRUCTIONS_Y), _level->levelTextRot(this), color);
 	}
 	
 	// Draw gravity vector.
 	int gravAlpha = _level->gravityArrowAlpha(this);
 	if(gravAlpha > 0)
 	{
-		ofPoint rawAccel = ofxAccelerometer.getAccelOrientation();
-		ofPoint fixedAccel(rawAccel.x, -rawAccel.y);
-		float rad = atan2(fixedAccel.y, fixedAccel.x);
-		float length = sqrt(fixedAccel.x*fixedAccel.x + fixedAccel.y*fixedAccel.y);
-		ofPushStyle();
-		ofSetColor(GRAVITY_ARROW_R, GRAVITY_ARROW_G, GRAVITY_ARROW_B, GRAVITY_ARROW_A * gravAlpha / 255);
-		drawArrow(SCREEN_CENTER, ofRadToDeg(rad), length * GRAVITY_ARROW_LENGTH, GRAVITY_ARROW_TEXT);
-		ofPopStyle();
+		float rad = atan2(_gravity.y, _gravity.x);
+		float length = sqrt(_gravity.x*_gravity.x + _gravity.y*_gravity.y);
+		IntColor color(GRAVITY_ARROW_R, GRAVITY_ARROW_G, GRAVITY_ARROW_B, GRAVITY_ARROW_A * gravAlpha / 255);
+		renderArrow(snapshot, SCREEN_CENTER, ofRadToDeg(rad), length * GRAVITY_ARROW_LENGTH, color, GRAVITY_ARROW_TEXT);
 	}
 	
-	// Draw game objects.
-	GameObjectIter iter;
-	for(iter = _gobjects.begin(); iter != _gobjects.end(); ++iter)
-		(*iter)->draw();
+	// Draw dust.
+	snapshot->setLayer(RENDER_LAYER_DUST);
+	_dust.render(snapshot, _renderQuality->dustStride);
 	
-	// Draw level text.
-	if(_frames < LEVEL_TEXT_DURATION)
+	// Draw game objects, on the render pool if there are enough to be worth sharing out.
+	if(_renderPool != NULL && _renderPool->threadCount() > 0 && (int)_gobjects.size() > RENDER_CHUNK_SIZE)
+	{
+		renderInChunks(snapshot);
+	}
+	else
+	{
+		GameObjectIter iter;
+		for(iter = _gobjects.begin(); iter != _gobjects.end(); ++iter)
+		{
+			snapshot->setLayer((*iter)->renderLayer());
+			(*iter)->render(snapshot);
+		}
+	}
+	
+	snapshot->setLayer(RENDER_LAYER_OVERLAY);
+	
+	// Draw level text. Headless games don't know their level number.
+	if(_frames < LEVEL_TEXT_DURATION && _app)
 	{
 		const int LEVEL_STR_LEN = 20;
 		char str[20];
@@ -326,21 +1129,35 @@ void Game::draw()
 		float scaledFloatAlpha = floatAlpha * LEVEL_TEXT_A / 255;
 		int intAlpha = scaledFloatAlpha * 255;
 		
-		float width = _app->fontBig()->stringWidth(str);
-		float height = _app->fontBig()->stringHeight(str);
-		float xOffset = -width/2;
-		float yOffset = -height/2 + _app->fontBig()->getLineHeight()/2;
-		
-		ofPushStyle();
-		ofPushMatrix();
-		ofTranslate(LEVEL_TEXT_X, LEVEL_TEXT_Y);
-		ofRotateZ(_level->levelTextRot(this));
-		ofTranslate(xOffset, yOffset);
-		ofSetColor(LEVEL_TEXT_R, LEVEL_TEXT_G, LEVEL_TEXT_B, intAlpha);
-		_app->fontBig()->drawString(str, 0, 0);
-		ofPopMatrix();
-		ofPopStyle();
+		IntColor color(LEVEL_TEXT_R, LEVEL_TEXT_G, LEVEL_TEXT_B, intAlpha);
+		snapshot->text(str, RENDER_FONT_BIG, Vec2(LEVEL_TEXT_X, LEVEL_TEXT_Y), _level->levelTextRot(this), color);
 	}
+	
+	_stats.drawMicros = stopwatch.elapsedMicros();
+	
+	if(TELEMETRY && _app)
+		publishTelemetry();
+}
+
+/**
+ * Writes the stats of the frame just recorded to the application's telemetry ring.
+ */
+void Game::publishTelemetry()
+{
+	TelemetryRecord record;
+	record.frame = _frames;
+	record.updateMicros = _stats.updateMicros;
+	record.collisionMicros = _stats.collisionMicros;
+	record.recordMicros = _stats.drawMicros;
+	record.drawMicros = _app->drawMicros();
+	record.players = _players.size();
+	record.bullets = _bullets.size();
+	record.enemies = enemyCount();
+	record.gobjects = _gobjects.size();
+	record.collisionTests = _stats.collisionTests;
+	record.objectsAdded = _stats.objectsAdded;
+	record.qualityLevel = _stats.qualityLevel;
+	_app->telemetry()->write(record);
 }
 
 /**
@@ -349,6 +1166,7 @@ void Game::draw()
  */
 void Game::win()
 {
+	TRACE_INSTANT("win");
 	nextAtFrame(_frames + WIN_DURATION);
 	
 	// Create win effect.
@@ -371,6 +1189,7 @@ void Game::win()
  */
 void Game::lose()
 {
+	TRACE_INSTANT("lose");
 	resetAtFrame(_frames + LOSE_DURATION);
 	
 	// Create lose effect.
@@ -388,70 +1207,128 @@ void Game::lose()
 }
 
 /**
- * Resets the level at the end of the specified frame.
+ * Resets the level at the start of the specified frame.
  */
 void Game::resetAtFrame(int frame)
 {
 	_resetAtFrame = frame;
+	scheduleEvent(&_resetTimer, frame, GAME_TIMER_RESET);
 }
 
 /**
- * Moves to the next level at the end of the specified frame.
+ * Moves to the next level at the start of the specified frame.
  */
 void Game::nextAtFrame(int frame)
 {
 	_nextAtFrame = frame;
+	scheduleEvent(&_nextTimer, frame, GAME_TIMER_NEXT);
 }
 
 /**
- * Wins the game at the end of the specified frame.
+ * Wins the game at the start of the specified frame.
  */
 void Game::winAtFrame(int frame)
 {
 	_winAtFrame = frame;
+	scheduleEvent(&_winTimer, frame, GAME_TIMER_WIN);
 }
 
 /**
- * Loses the game at the end of the specified frame.
+ * Loses the game at the start of the specified frame.
  */
 void Game::loseAtFrame(int frame)
 {
 	_loseAtFrame = frame;
+	scheduleEvent(&_loseTimer, frame, GAME_TIMER_LOSE);
+}
+
+/**
+ * Schedules one of the game's own events, replacing any earlier schedule for it.
+ */
+void Game::scheduleEvent(TimerId* timer, int frame, int tag)
+{
+	_timers.cancel(*timer);
+	*timer = _timers.schedule(frame, this, tag);
+}
+
+/**
+ * Called by the timer wheel when one of the game's own timers is due.
+ */
+void Game::timerFired(int tag)
+{
+	switch(tag)
+	{
+		case GAME_TIMER_WIN:
+			win();
+			break;
+		case GAME_TIMER_LOSE:
+			lose();
+			break;
+		case GAME_TIMER_RESET:
+			_retryDue = true;
+			break;
+		case GAME_TIMER_NEXT:
+			if(_app)
+				_app->nextLevel();
+			break;
+		default:
+			spawn(_spawnWaves[tag - GAME_TIMER_SPAWN]);
+			_pendingSpawnWaves--;
+			break;
+	}
+}
+
+/**
+ * Records the game objects on the render pool, a chunk per job. The jobs first
+ * count their chunks' items, then a run is reserved for each chunk in order and
+ * the jobs fill in their runs, so the snapshot holds exactly what recording the
+ * objects one by one would have, without copying anything.
+ */
+void Game::renderInChunks(RenderSnapshot* snapshot)
+{
+	int count = _gobjects.size();
+	int chunkCount = (count + RENDER_CHUNK_SIZE - 1) / RENDER_CHUNK_SIZE;
+	if((int)_renderJobs.size() < chunkCount)
+		_renderJobs.resize(chunkCount);
+	
+	int i;
+	for(i = 0; i < chunkCount; i++)
+	{
+		_renderJobs[i].setup(this, i * RENDER_CHUNK_SIZE, min(count, (i + 1) * RENDER_CHUNK_SIZE));
+		_renderPool->submit(&_renderJobs[i]);
+	}
+	_renderPool->wait();
+	
+	int total = 0;
+	for(i = 0; i < chunkCount; i++)
+		total += _renderJobs[i].itemCount();
+	int first = snapshot->reserve(total);
+	for(i = 0; i < chunkCount; i++)
+	{
+		_renderJobs[i].recordInto(snapshot, first);
+		first += _renderJobs[i].itemCount();
+		_renderPool->submit(&_renderJobs[i]);
+	}
+	_renderPool->wait();
 }
 
 /**
- * Draws the gravity arrow.
+ * Records the gravity arrow.
  * @param start The starting point of the arrow.
  * @param deg The direction (in degrees) in which the arrow should point.
  * @param length The length of the arrow.
+ * @param color The color of the arrow and its text.
  * @param text The text to display at the end of the arrow, or NULL to display no text.
  */
-void Game::drawArrow(ofPoint start, float deg, float length, const char* text)
+void Game::renderArrow(RenderSnapshot* snapshot, Vec2 start, float deg, float length, IntColor color, const char* text)
 {
-	ofPushMatrix();
-	ofTranslate(start.x, start.y);
-	ofRotateZ(deg);
-	
-	ofLine(0, 0, length, 0);
-	ofLine(length-10, -10, length, 0);
-	ofLine(length-10, 10, length, 0);
+	Vec2 tip = start + FastMath::rotate(Vec2(length, 0), deg);
+	snapshot->line(start, tip, color);
+	snapshot->line(start + FastMath::rotate(Vec2(length-10, -10), deg), tip, color);
+	snapshot->line(start + FastMath::rotate(Vec2(length-10, 10), deg), tip, color);
 	
 	if(text != NULL)
-	{
-		float width = _app->fontSmall()->stringWidth(text);
-		float height = _app->fontSmall()->stringHeight(text);
-		float xOffset = -width/2;
-		float yOffset = -height/2 + _app->fontSmall()->getLineHeight();
-		
-		ofPushMatrix();
-		ofTranslate(length, 0);
-		ofRotateZ(-90);
-		ofTranslate(xOffset, yOffset);
-		_app->fontSmall()->drawString(text, 0, 0);
-		ofPopMatrix();
-	}
-	
-	ofPopMatrix();
+		snapshot->text(text, RENDER_FONT_SMALL, tip, deg - 90, color, true, 1);
 }
 
 /**
@@ -483,7 +1360,8 @@ void Game::touchUp(float x, float y, int touchId, ofxMultiTouchCustomData *data)
  */
 void Game::touchDoubleTap(float x, float y, int touchId, ofxMultiTouchCustomData *data)
 {
-	
+	if(REWIND_DEBUG)
+		rewind(REWIND_TAP_SNAPSHOTS);
 }
 
 /**
@@ -502,6 +1380,47 @@ int Game::frames()
 	return _frames;
 }
 
+/**
+ * Returns the timer wheel on which game objects schedule frame-based events.
+ */
+TimerWheel* Game::timers()
+{
+	return &_timers;
+}
+
+/**
+ * Returns the object that predicts when bullets will hit enemies.
+ */
+HitPredictor* Game::predictor()
+{
+	return &_predictor;
+}
+
+/**
+ * Returns the random number generator used for everything random in the game.
+ * It is part of the game's snapshots, so restored games replay the same numbers.
+ */
+Random* Game::random()
+{
+	return &_random;
+}
+
+/**
+ * Returns the instrumentation counters for the most recent update and draw.
+ */
+FrameStats* Game::stats()
+{
+	return &_stats;
+}
+
+/**
+ * Returns what to draw while recording a frame. Only valid during render().
+ */
+const RenderQuality* Game::renderQuality()
+{
+	return _renderQuality;
+}
+
 /**
  * Returns the number of the current level.
  */
@@ -2,6 +2,21 @@
 
 #include "AppState.h"
 #include "GameObject.h"
+#include "FrameStats.h"
+#include "SpawnWave.h"
+#include "TimerWheel.h"
+#include "HitPredictor.h"
+#include "Random.h"
+#include "Snapshot.h"
+#include "RewindBuffer.h"
+#include "GravityPolicy.h"
+#include "UpdateJob.h"
+#include "RenderJob.h"
+#include "CommandBuffer.h"
+#include "RenderSnapshot.h"
+#include "QualityScaler.h"
+#include "DustField.h"
+#include <map>
 
 class App;
 class LevelBase;
@@ -10,37 +25,130 @@ class Player;
 class Bullet;
 class Enemy;
 
+/**
+ * An enemy that has been taken out of the update loop until a particular frame.
+ */
+struct SleepingEnemy
+{
+	int wakeFrame; // The frame at the start of which the enemy rejoins the game.
+	Enemy* enemy; // The sleeping enemy.
+	shared_ptr<GameObject> gobject; // The enemy, kept alive while outside the GameObjects list.
+	TimerId wakeTimer; // The timer that will wake the enemy.
+};
+
+/**
+ * A player removed from the game during the current frame.
+ */
+struct RemovedPlayer
+{
+	Vec2 loc; // Where the player stood.
+	int order; // The add order of the object whose turn marked the player for removal, or -1.
+};
+
+/**
+ * The tags of the timers the Game schedules for itself.
+ * Spawn wave timers use GAME_TIMER_SPAWN plus the index of the wave.
+ */
+enum GameTimer
+{
+	GAME_TIMER_WIN,
+	GAME_TIMER_LOSE,
+	GAME_TIMER_RESET,
+	GAME_TIMER_NEXT,
+	GAME_TIMER_SPAWN
+};
+
 /**
  * An application state that implements the high-level game logic.
  * A single Game object exists for the duration of a level.
  */
-class Game : public AppState
+class Game : public AppState, public TimerListener
 {
 private:
 	
 	App* _app;
+	TimerWheel _timers; // Declared before the game objects so that it outlives them.
+	HitPredictor _predictor;
+	Random _random;
+	Snapshot _startSnapshot;
+	Snapshot _rewindSnapshot;
+	RewindBuffer _rewind;
+	bool _retryDue;
 	shared_ptr<LevelBase> _level;
+	shared_ptr<GravityPolicy> _gravityPolicy;
+	Vec2 _gravity;
+	DustField _dust;
+	ThreadPool* _updatePool;
+	ThreadPool* _renderPool;
+	vector<UpdateJob> _steerJobs;
+	vector<UpdateJob> _bulletJobs;
+	vector<RenderJob> _renderJobs;
+	vector<CommandBuffer*> _phaseBuffers;
+	CommandBuffer _phaseCommands; // The commands recorded by the update phases, merged.
+	CommandBuffer _turnCommands; // The commands recorded by an enemy updated in turn.
+	CommandBuffer _commands; // The adds, removals, sleeps, and hits of the current tick.
+	int _turnOrder; // The add order of the object being updated, or -1.
 	vector<shared_ptr<GameObject> > _gobjects;
-	vector<shared_ptr<GameObject> > _gobjectsToAdd;
 	vector<GameObject*> _gobjectsToRemove;
 	vector<Player*> _players;
 	vector<Bullet*> _bullets;
 	vector<Enemy*> _enemies;
+	map<Enemy*, SleepingEnemy> _sleepingEnemies;
+	vector<SleepingEnemy> _enemiesToSleep;
+	vector<Enemy*> _enemiesToWake;
+	bool _playersStationary;
+	bool _playersChanged;
+	vector<RemovedPlayer> _removedPlayers; // The players removed by the current tick's commands.
+	int _nextAddOrder;
+	vector<SpawnWave> _spawnWaves;
+	int _pendingSpawnWaves;
 	int _frames;
 	int _resetAtFrame;
 	int _nextAtFrame;
 	int _winAtFrame;
 	int _loseAtFrame;
+	TimerId _resetTimer;
+	TimerId _nextTimer;
+	TimerId _winTimer;
+	TimerId _loseTimer;
+	FrameStats _stats;
+	const RenderQuality* _renderQuality;
+	
+	void insertGameObject(shared_ptr<GameObject> gobject);
+	shared_ptr<GameObject> createGameObject(GameObjectType type, Snapshot* snapshot);
+	void scheduleEvent(TimerId* timer, int frame, int tag);
+	bool canUpdateInPhases();
+	void updateInPhases();
+	void timeBulletRun(GameObject* gobject, long long* since);
+	int runUpdatePhase(UpdatePhase phase, int count, vector<UpdateJob>& jobs);
+	void renderInChunks(RenderSnapshot* snapshot);
+	void applyCommands();
+	int lastFrameWalked(Enemy* enemy, int lastFrame);
+	void publishTelemetry();
 	
 public:
 	
-	Game(App* app, shared_ptr<LevelBase> level);
+	Game(App* app, shared_ptr<LevelBase> level, unsigned int seed=0);
 	
 	void addGameObject(shared_ptr<GameObject> gobject);
 	void delayAddGameObject(shared_ptr<GameObject> gobject);
 	void removeGameObject(GameObject* gobject);
 	void delayRemoveGameObject(GameObject* gobject);
 	bool isMarkedForRemoval(GameObject* gobject);
+	void hitObject(GameObject* target);
+	bool applyTurn(CommandBuffer* commands, int begin, int end);
+	CommandBuffer* turnCommands();
+	void scheduleSpawn(const SpawnWave& wave);
+	void spawn(const SpawnWave& wave);
+	int pendingSpawnCount();
+	void delaySleepEnemy(Enemy* enemy, int wakeFrame);
+	void delayWakeEnemy(Enemy* enemy);
+	void sleepEnemies();
+	void wakeEnemies(vector<Enemy*>& enemies, int lastFrame);
+	void wakeAllEnemies(int lastFrame);
+	bool playersStationary();
+	int enemyCount();
+	int awakeEnemyCount();
 	GameObjectIter gameObjectsBegin();
 	GameObjectIter gameObjectsEnd();
 	vector<Player*>::iterator playersBegin();
@@ -50,8 +158,20 @@ public:
 	vector<Enemy*>::iterator enemiesBegin();
 	vector<Enemy*>::iterator enemiesEnd();
 	
-	void activate();
-	void draw();
+	void saveSnapshot(Snapshot* snapshot);
+	void restoreSnapshot(Snapshot* snapshot);
+	void retry();
+	bool rewind(int snapshots);
+	
+	void setGravityPolicy(shared_ptr<GravityPolicy> policy);
+	void setUpdatePool(ThreadPool* pool);
+	ThreadPool* updatePool();
+	void setRenderPool(ThreadPool* pool);
+	Vec2 gravity();
+	bool isWon();
+	bool isLost();
+	
+	void render(RenderSnapshot* snapshot);
 	void update();
 	
 	void win();
@@ -60,8 +180,9 @@ public:
 	void nextAtFrame(int frame);
 	void winAtFrame(int frame);
 	void loseAtFrame(int frame);
+	void timerFired(int tag);
 	
-	void drawArrow(ofPoint start, float deg, float length, const char* text=NULL);
+	void renderArrow(RenderSnapshot* snapshot, Vec2 start, float deg, float length, IntColor color, const char* text=NULL);
 	
 	void touchDown(float x, float y, int touchId, ofxMultiTouchCustomData *data);
 	void touchMoved(float x, float y, int touchId, ofxMultiTouchCustomData *data);
@@ -71,4 +192,9 @@ public:
 	App* app();
 	LevelBase* level();
 	int frames();
+	TimerWheel* timers();
+	HitPredictor* predictor();
+	Random* random();
+	FrameStats* stats();
+	const RenderQuality* renderQuality();
 };
\ No newline at end of file
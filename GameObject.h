@@ -1,6 +1,22 @@
 #pragma once
 
+#include "Vec2.h"
+#include "RenderSnapshot.h"
+
 class Game;
+class Snapshot;
+
+/**
+ * Identifies the concrete type of a GameObject in a snapshot.
+ */
+enum GameObjectType
+{
+	GAMEOBJECT_NONE,
+	GAMEOBJECT_PLAYER,
+	GAMEOBJECT_BULLET,
+	GAMEOBJECT_ENEMY,
+	GAMEOBJECT_CIRCLE_EFFECT
+};
 
 /**
  * The base class for objects in the game that are updated and drawn.
@@ -10,13 +26,27 @@ class GameObject
 protected:
 	
 	Game* _game;
+	int _addOrder;
+	bool _markedForRemoval;
 	
 public:
 	
-	GameObject(Game* game){_game = game;}
+	GameObject(Game* game){_game = game; _addOrder = 0; _markedForRemoval = false;}
+	virtual ~GameObject(){}
 	
 	virtual void update(){}
-	virtual void draw(){}
+	virtual void render(RenderSnapshot* snapshot){} // Records what this object looks like this frame.
+	virtual int renderItemCount(){return 0;} // The number of items render() records this frame.
+	virtual RenderLayer renderLayer(){return RENDER_LAYER_EFFECTS;} // The layer this object is drawn in.
+	virtual void hit(){} // Called when something runs into this object.
+	
+	virtual GameObjectType type(){return GAMEOBJECT_NONE;}
+	virtual void save(Snapshot* snapshot){} // Writes the state read back by the type's snapshot constructor.
+	
+	int addOrder(){return _addOrder;} // The order in which this object was added to the game.
+	void setAddOrder(int addOrder){_addOrder = addOrder;}
+	bool isMarkedForRemoval(){return _markedForRemoval;} // Whether this object leaves the game at the end of the tick.
+	void markForRemoval(){_markedForRemoval = true;}
 };
 
 typedef vector<shared_ptr<GameObject> >::iterator GameObjectIter;
@@ -3,6 +3,7 @@
 #include "Player.h"
 #include "rules.h"
 #include "Enemy.h"
+#include "SpawnWave.h"
 
 /**
  * Creates a new GenericLevel object that prodided information to
@@ -15,7 +16,8 @@ GenericLevel::GenericLevel(GenericLevelRules* rules)
 
 /**
  * Called by the Game to populate the GameObjects.
- * Calls the Game's addGameObject method to populate players and enemies.
+ * Calls the Game's addGameObject method to populate players
+ * and scheduleSpawn method to schedule the enemies.
  */
 void GenericLevel::populateGame(Game* game)
 {
@@ -27,16 +29,15 @@ void GenericLevel::populateGame(Game* game)
 		game->addGameObject(shared_ptr<Player>(player));
 	}
 	
-	// Create enemies.
-	for(i = 0; i < _rules->enemyCount; i++)
+	// Schedule enemies.
+	if(_rules->spawnWaves == NULL)
 	{
-		int deg = rand() % 360;
-		float rad = ofDegToRad(deg);
-		int dist = rand() % (ENEMY_MAX_DIST - ENEMY_MIN_DIST) + ENEMY_MIN_DIST;
-		ofPoint offset(dist * cos(rad), dist * sin(rad));
-		
-		Enemy* enemy = new Enemy(game, _rules->enemyRules, offset + SCREEN_CENTER);
-		game->addGameObject(shared_ptr<Enemy>(enemy));
+		game->scheduleSpawn(SpawnWave::allAtOnce(_rules->enemyCount, _rules->enemyRules));
+	}
+	else
+	{
+		for(i = 0; i < _rules->spawnWaveCount; i++)
+			game->scheduleSpawn(_rules->spawnWaves[i]);
 	}
 }
 
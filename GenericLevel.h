@@ -5,6 +5,7 @@
 class Game;
 struct PlayerRules;
 struct EnemyRules;
+struct SpawnWave;
 
 /**
  * Contains the rules for a particular level.
@@ -13,12 +14,14 @@ struct GenericLevelRules
 {
 	PlayerRules* playerRules[4]; // The rules for each player ship.
 	int playerCount; // The number of player ships.
-	int enemyCount; // The number of initial enemies.
+	int enemyCount; // The number of enemies spawned at the start when there is no spawn schedule.
 	EnemyRules* enemyRules; // The rules for the enemies.
 	const char* instructions; // The instruction text to show to the player, or NULL to display no instructions.
 	int gravityArrowAlpha; // The alpha translucency with which to draw the gravity arrow.
 	int pathProjectionAlpha; // The alpha translucency with which to draw the bullet path projection.
 	int pathProjectionCount; // The number of steps to iterate the bullet path projection into the future.
+	SpawnWave* spawnWaves; // The enemy spawn schedule, or NULL to spawn every enemy at the start of the level.
+	int spawnWaveCount; // The number of waves in the spawn schedule.
 };
 
 /**
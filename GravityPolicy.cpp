@@ -0,0 +1,241 @@
+#include "GravityPolicy.h"
+#include "Random.h"
+#include "AccelSampler.h"
+#include "Stopwatch.h"
+#include "Game.h"
+#include "Player.h"
+#include "Enemy.h"
+#include "Bullet.h"
+#include "FastMath.h"
+#include "rules.h"
+#include <float.h>
+
+// The number of directions a turning script steps through.
+#define TURNING_STEPS 8
+
+/**
+ * Returns the current gravity acceleration, from the accelerometer.
+ */
+Vec2 AccelerometerGravity::gravity(int frame)
+{
+	ofPoint rawAccel = ofxAccelerometer.getRawAcceleration();
+	return Vec2(rawAccel.x, -rawAccel.y);
+}
+
+/**
+ * Creates a policy that consumes the samples queued on the specified ring.
+ * Until the first sample arrives there is no gravity.
+ */
+SampledGravity::SampledGravity(AccelRing* ring)
+{
+	_ring = ring;
+	_sampled = false;
+	_newestMicros = 0;
+	_inputAgeMicros = 0;
+}
+
+/**
+ * Consumes the samples queued since the last call and returns the filtered gravity.
+ * If none were queued, the gravity stays as it was.
+ */
+Vec2 SampledGravity::gravity(int frame)
+{
+	AccelSample sample;
+	while(_ring->pop(&sample))
+	{
+		if(_sampled)
+			_filtered += (sample.accel - _filtered) * ACCEL_FILTER;
+		else
+			_filtered = sample.accel;
+		_sampled = true;
+		_newestMicros = sample.micros;
+	}
+	if(_sampled)
+		_inputAgeMicros = Stopwatch::nowMicros() - _newestMicros;
+	return Vec2(_filtered.x, -_filtered.y);
+}
+
+/**
+ * Returns how long before the latest call to gravity() its newest sample was taken.
+ */
+long long SampledGravity::inputAgeMicros()
+{
+	return _inputAgeMicros;
+}
+
+/**
+ * Creates a script from the specified keys.
+ * @param keys The keys, in increasing order of frame. The first should be at frame 0;
+ * before it there is no gravity.
+ * @param keyCount The number of keys.
+ * @param loopFrames The length of the script if it repeats, or 0 to hold the last key forever.
+ */
+ScriptedGravity::ScriptedGravity(const GravityKey* keys, int keyCount, int loopFrames)
+{
+	_keys.assign(keys, keys + keyCount);
+	_loopFrames = loopFrames;
+}
+
+/**
+ * Returns the gravity of the last key at or before the specified frame.
+ */
+Vec2 ScriptedGravity::gravity(int frame)
+{
+	if(_loopFrames > 0)
+		frame %= _loopFrames;
+	
+	Vec2 gravity;
+	vector<GravityKey>::iterator iter;
+	for(iter = _keys.begin(); iter != _keys.end() && iter->frame <= frame; ++iter)
+		gravity = iter->gravity;
+	return gravity;
+}
+
+/**
+ * Creates a script that starts pointing down the screen and turns an eighth of
+ * a circle clockwise every holdFrames frames, forever.
+ * The caller owns the returned script.
+ */
+ScriptedGravity* ScriptedGravity::turning(int holdFrames, float magnitude)
+{
+	GravityKey keys[TURNING_STEPS];
+	int i;
+	for(i = 0; i < TURNING_STEPS; i++)
+	{
+		float rad = HALF_PI + i * TWO_PI / TURNING_STEPS;
+		keys[i].frame = i * holdFrames;
+		keys[i].gravity = Vec2(cos(rad), sin(rad)) * magnitude;
+	}
+	return new ScriptedGravity(keys, TURNING_STEPS, TURNING_STEPS * holdFrames);
+}
+
+/**
+ * Creates a random gravity.
+ * @param seed Picks the sequence of gravities. Equal seeds give equal sequences.
+ * @param holdFrames The number of frames for which each gravity is held.
+ * @param maxMagnitude The strongest gravity to pick.
+ */
+RandomGravity::RandomGravity(unsigned int seed, int holdFrames, float maxMagnitude)
+{
+	_seed = seed;
+	_holdFrames = holdFrames;
+	_maxMagnitude = maxMagnitude;
+}
+
+/**
+ * Returns the gravity picked for the stretch of frames containing the specified frame.
+ */
+Vec2 RandomGravity::gravity(int frame)
+{
+	// Mix the stretch into the seed so that neighboring stretches are unrelated.
+	unsigned int stretch = frame / _holdFrames;
+	Random random(_seed ^ (stretch * 0x9e3779b9));
+	random.next();
+	float rad = random.nextInt(3600) * TWO_PI / 3600;
+	float magnitude = random.nextInt(1001) * _maxMagnitude / 1000;
+	return Vec2(cos(rad), sin(rad)) * magnitude;
+}
+
+/**
+ * Creates a policy that aims at the enemies of the specified game.
+ * @param game The game to play. Must outlive the policy.
+ * @param magnitude The strongest gravity to tilt.
+ * @param maxFlightFrames The longest flight considered for a shot.
+ */
+AimedGravity::AimedGravity(Game* game, float magnitude, int maxFlightFrames)
+{
+	_game = game;
+	_magnitude = magnitude;
+	_maxFlightFrames = maxFlightFrames;
+}
+
+/**
+ * Returns the gravity that bends a shot onto where the enemy closest to a player will be
+ * when the shot gets there, or no gravity if no enemy is on the screen or no shot can reach one.
+ */
+Vec2 AimedGravity::gravity(int frame)
+{
+	// Find the enemy on the screen closest to a player, which is the most urgent to shoot.
+	Player* player = NULL;
+	Enemy* nearest = NULL;
+	float nearestDistSquared = 0;
+	vector<Player*>::iterator playerIter;
+	vector<Enemy*>::iterator enemyIter;
+	for(playerIter = _game->playersBegin(); playerIter != _game->playersEnd(); ++playerIter)
+	{
+		for(enemyIter = _game->enemiesBegin(); enemyIter != _game->enemiesEnd(); ++enemyIter)
+		{
+			if(!(*enemyIter)->isOnScreen())
+				continue;
+			Vec2 diff = (*enemyIter)->loc() - (*playerIter)->loc();
+			float distSquared = diff.x*diff.x + diff.y*diff.y;
+			if(nearest == NULL || distSquared < nearestDistSquared)
+			{
+				player = *playerIter;
+				nearest = *enemyIter;
+				nearestDistSquared = distSquared;
+			}
+		}
+	}
+	if(nearest == NULL)
+		return Vec2();
+	
+	// Steer the oldest shot in flight that can still be bent onto the enemy,
+	// or else the next one the player fires.
+	PlayerRules* rules = player->rules();
+	Vec2 enemyVel = nearest->velocityTowards(nearest->loc(), player->loc());
+	Vec2 gravity;
+	vector<Bullet*>::iterator bulletIter;
+	for(bulletIter = _game->bulletsBegin(); bulletIter != _game->bulletsEnd(); ++bulletIter)
+	{
+		if(aimShot((*bulletIter)->loc(), (*bulletIter)->vel(), nearest->loc(), enemyVel, rules->bulletRules, &gravity))
+			return gravity;
+	}
+	Vec2 fireVel = FastMath::rotate(rules->fireVel, player->rot());
+	aimShot(player->loc(), fireVel, nearest->loc(), enemyVel, rules->bulletRules, &gravity);
+	return gravity;
+}
+
+/**
+ * Finds the gravity that bends a shot onto a moving target soonest while it stays on the screen.
+ * A shot at loc with velocity vel under acceleration a has moved n*vel + a*n*(n-1)/2 after
+ * n frames, so every flight time gives an acceleration that hits.
+ * @param gravity Set to that gravity, or to no gravity if there is none.
+ * @return Whether any flight time needs no more gravity than the policy's magnitude.
+ */
+bool AimedGravity::aimShot(Vec2 loc, Vec2 vel, Vec2 target, Vec2 targetVel, BulletRules* rules, Vec2* gravity)
+{
+	int n;
+	for(n = 2; n <= _maxFlightFrames; n++)
+	{
+		Vec2 accel = (target + targetVel * n - loc - vel * n) * (2.0f / (n * (n - 1)));
+		*gravity = accel / rules->gravityFactor;
+		if(gravity->x*gravity->x + gravity->y*gravity->y <= _magnitude*_magnitude &&
+		   staysOnScreen(loc, vel, accel, n, rules))
+			return true;
+	}
+	*gravity = Vec2();
+	return false;
+}
+
+/**
+ * Returns whether a shot that moves n*vel + accel*n*(n-1)/2 in n frames stays
+ * on the screen for the specified number of frames. Each axis of the path is a
+ * parabola, so only the ends and the turning point of each axis need checking.
+ */
+bool AimedGravity::staysOnScreen(Vec2 loc, Vec2 vel, Vec2 accel, int frames, BulletRules* rules)
+{
+	float checks[4] = {0, (float)frames, 0, 0};
+	if(accel.x != 0)
+		checks[2] = min(max(0.5f - vel.x / accel.x, 0.0f), (float)frames);
+	if(accel.y != 0)
+		checks[3] = min(max(0.5f - vel.y / accel.y, 0.0f), (float)frames);
+	int i;
+	for(i = 0; i < 4; i++)
+	{
+		float k = checks[i];
+		if(Bullet::isOffScreen(loc + vel * k + accel * (k * (k - 1) / 2), rules))
+			return false;
+	}
+	return true;
+}
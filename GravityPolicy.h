@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Vec2.h"
+
+class AccelRing;
+class Game;
+struct BulletRules;
+
+/**
+ * Decides the gravity acting on a game each frame.
+ * The game samples its policy once at the start of every frame, so bullets,
+ * dust, and the hit predictor all see the same value throughout the frame.
+ */
+class GravityPolicy
+{
+public:
+	
+	virtual ~GravityPolicy(){}
+	
+	virtual Vec2 gravity(int frame) = 0;
+	virtual long long inputAgeMicros(){return 0;} // How old the input behind the latest gravity was when it was read.
+};
+
+/**
+ * Takes gravity from the device's accelerometer. Used when a person is playing.
+ */
+class AccelerometerGravity : public GravityPolicy
+{
+public:
+	
+	Vec2 gravity(int frame);
+};
+
+/**
+ * Takes gravity from the samples an AccelSampler queues. Each call consumes every
+ * sample taken since the previous one and passes them through a one-pole low-pass
+ * filter, ACCEL_FILTER, so the result doesn't depend on when within a tick the
+ * call happens. Used when a person is playing with ACCEL_SAMPLER set.
+ * Must be the only consumer of its ring.
+ */
+class SampledGravity : public GravityPolicy
+{
+private:
+	
+	AccelRing* _ring;
+	Vec2 _filtered; // The filtered acceleration, in the accelerometer's own axes.
+	bool _sampled; // Whether any sample has been consumed yet.
+	long long _newestMicros; // When the newest consumed sample was taken.
+	long long _inputAgeMicros;
+	
+public:
+	
+	SampledGravity(AccelRing* ring);
+	
+	Vec2 gravity(int frame);
+	long long inputAgeMicros();
+};
+
+/**
+ * A gravity that changes at particular frames, for playing games without a device.
+ */
+struct GravityKey
+{
+	int frame; // The frame from which this gravity applies.
+	Vec2 gravity; // The gravity until the next key.
+};
+
+/**
+ * Follows a fixed script of gravity keys, optionally repeating it.
+ */
+class ScriptedGravity : public GravityPolicy
+{
+private:
+	
+	vector<GravityKey> _keys;
+	int _loopFrames;
+
+public:
+	
+	ScriptedGravity(const GravityKey* keys, int keyCount, int loopFrames=0);
+	
+	Vec2 gravity(int frame);
+	
+	static ScriptedGravity* turning(int holdFrames, float magnitude);
+};
+
+/**
+ * Holds a random gravity for a number of frames and then picks another.
+ * The gravity of a frame depends only on the seed and the frame, so the policy
+ * keeps no state between calls and agrees with itself when a game is rewound.
+ */
+class RandomGravity : public GravityPolicy
+{
+private:
+	
+	unsigned int _seed;
+	int _holdFrames;
+	float _maxMagnitude;
+
+public:
+	
+	RandomGravity(unsigned int seed, int holdFrames, float maxMagnitude);
+	
+	Vec2 gravity(int frame);
+};
+
+/**
+ * Plays a game the way a person would: tilts so that the players' shots bend
+ * onto the enemy closest to them.
+ * The gravity of a frame depends only on the game's state at the start of the frame,
+ * so the policy keeps no state between calls and agrees with itself when a game is rewound.
+ */
+class AimedGravity : public GravityPolicy
+{
+private:
+	
+	Game* _game;
+	float _magnitude;
+	int _maxFlightFrames;
+	
+	bool aimShot(Vec2 loc, Vec2 vel, Vec2 target, Vec2 targetVel, BulletRules* rules, Vec2* gravity);
+	bool staysOnScreen(Vec2 loc, Vec2 vel, Vec2 accel, int frames, BulletRules* rules);
+
+public:
+	
+	AimedGravity(Game* game, float magnitude, int maxFlightFrames);
+	
+	Vec2 gravity(int frame);
+};
@@ -0,0 +1,257 @@
+#include "HitPredictor.h"
+#include "rules.h"
+#include "Game.h"
+#include "Player.h"
+#include "Bullet.h"
+#include "Enemy.h"
+#include <limits.h>
+#include <float.h>
+
+/**
+ * Constructs a new HitPredictor for the specified game.
+ * Nothing is predicted until gravity and the players have held steady for a while.
+ */
+HitPredictor::HitPredictor(Game* game)
+{
+	_game = game;
+	reset();
+}
+
+/**
+ * Forgets everything, as if the predictor had just been created.
+ * The bullets' own predictions must be cleared separately.
+ */
+void HitPredictor::reset()
+{
+	_active = false;
+	_steadyFrames = 0;
+	_gravity = Vec2();
+	_arrivedEnemies.clear();
+}
+
+/**
+ * Called by the game at the start of each frame, once the frame's timers have fired
+ * and any new enemies have arrived, but before any game object is updated.
+ * Predicts hits for the bullets that don't have a prediction and checks the newly
+ * arrived enemies against the bullets that do.
+ */
+void HitPredictor::refresh()
+{
+	if(!HIT_PREDICTION)
+		return;
+	
+	// Predictions only hold while gravity is exactly what it was last frame and no
+	// player has moved. Wait for the input to settle before predicting again so that
+	// a jittery accelerometer doesn't throw away a frame's worth of work every frame.
+	Vec2 gravity = _game->gravity();
+	bool steady = gravity.x == _gravity.x && gravity.y == _gravity.y && _game->playersStationary();
+	_gravity = gravity;
+	if(!steady)
+	{
+		if(_active)
+			invalidateAll();
+		_active = false;
+		_steadyFrames = 0;
+		return;
+	}
+	if(_steadyFrames < HIT_PREDICTION_STEADY_FRAMES)
+	{
+		_steadyFrames++;
+		return;
+	}
+	_active = true;
+	
+	vector<Bullet*>::iterator iter;
+	for(iter = _game->bulletsBegin(); iter != _game->bulletsEnd(); ++iter)
+	{
+		Bullet* bullet = *iter;
+		if(!bullet->hasPrediction())
+		{
+			// Check the bullet's whole flight against every enemy.
+			bullet->predictMiss();
+			tracePath(bullet, INT_MAX);
+			predict(bullet, _game->enemiesBegin(), _game->enemiesEnd());
+		}
+		else if(!_arrivedEnemies.empty())
+		{
+			// Only a new enemy can get in the way before the predicted hit.
+			int maxFrames = INT_MAX;
+			if(bullet->predictedEnemy() != NULL)
+				maxFrames = bullet->predictedFrame() - _game->frames() + 1;
+			tracePath(bullet, maxFrames);
+			predict(bullet, _arrivedEnemies.begin(), _arrivedEnemies.end());
+		}
+	}
+	_arrivedEnemies.clear();
+}
+
+/**
+ * Records the path of the specified bullet from the start of the current frame until it
+ * leaves the screen, or for at most the specified number of frames.
+ * The bullet's location after its update during the Nth frame is stored at index N-1.
+ */
+void HitPredictor::tracePath(Bullet* bullet, int maxFrames)
+{
+	_path.clear();
+	Vec2 loc = bullet->loc();
+	Vec2 vel = bullet->vel();
+	while((int)_path.size() < maxFrames)
+	{
+		Bullet::step(&loc, &vel, _gravity, bullet->rules());
+		if(Bullet::isOffScreen(loc, bullet->rules()))
+			break;
+		_path.push_back(loc);
+	}
+}
+
+/**
+ * Checks the traced path of the specified bullet against the specified enemies,
+ * replacing the bullet's prediction if one of them would be hit first.
+ * When two enemies would be hit during the same frame, the bullet hits the one it
+ * touches earliest in its step, then the one that comes first in the Enemies list,
+ * just as it would when testing every frame.
+ */
+void HitPredictor::predict(Bullet* bullet, vector<Enemy*>::iterator begin, vector<Enemy*>::iterator end)
+{
+	Enemy* best = bullet->predictedEnemy();
+	int bestFrames = _path.size();
+	float bestTime = FLT_MAX;
+	if(best != NULL)
+	{
+		bestFrames = bullet->predictedFrame() - _game->frames() + 1;
+		firstContact(bullet, best, bestFrames, &bestTime);
+	}
+	
+	bool changed = false;
+	vector<Enemy*>::iterator iter;
+	for(iter = begin; iter != end; ++iter)
+	{
+		Enemy* enemy = *iter;
+		if(_game->isMarkedForRemoval(enemy) || enemy == best)
+			continue;
+		
+		float time;
+		int frames = firstContact(bullet, enemy, bestFrames, &time);
+		if(frames == 0)
+			continue;
+		if(best == NULL || frames < bestFrames || time < bestTime ||
+		   (time == bestTime && enemy->addOrder() < best->addOrder()))
+		{
+			best = enemy;
+			bestFrames = frames;
+			bestTime = time;
+			changed = true;
+		}
+	}
+	
+	if(changed)
+		bullet->predictHit(best, _game->frames() + bestFrames - 1);
+}
+
+/**
+ * Returns during which of the next frames the specified bullet will first touch the
+ * specified enemy, counting the current frame as 1, or 0 if it won't within the
+ * specified number of frames. The bullet's path must already have been traced.
+ * @param time Receives when during that frame's step they touch. See Bullet::contactTime.
+ */
+int HitPredictor::firstContact(Bullet* bullet, Enemy* enemy, int maxFrames, float* time)
+{
+	Player* target = enemy->closestPlayer();
+	if(target == NULL)
+		return 0;
+	Vec2 targetLoc = target->loc();
+	Vec2 prevLoc = enemy->prevLoc();
+	Vec2 loc = enemy->loc();
+	
+	// Cheaply rule out enemies that can't get near the bullet's path. An enemy never strays
+	// from the line to its target by more than a step, nor goes further than it can walk.
+	float reach = enemy->rules()->speed * maxFrames;
+	Vec2 diff = targetLoc - loc;
+	float length = sqrt(diff.x*diff.x + diff.y*diff.y);
+	Vec2 farthest = length > reach ? loc + diff * (reach / length) : targetLoc;
+	float pad = enemy->rules()->radius + bullet->rules()->radius + enemy->rules()->speed + 1;
+	float minX = min(min(loc.x, farthest.x), prevLoc.x) - pad;
+	float maxX = max(max(loc.x, farthest.x), prevLoc.x) + pad;
+	float minY = min(min(loc.y, farthest.y), prevLoc.y) - pad;
+	float maxY = max(max(loc.y, farthest.y), prevLoc.y) + pad;
+	int i;
+	bool near = false;
+	for(i = 0; i < maxFrames && !near; i++)
+	{
+		Vec2 from = i > 0 ? _path[i - 1] : bullet->loc();
+		Vec2 to = _path[i];
+		near = max(from.x, to.x) > minX && min(from.x, to.x) < maxX &&
+		       max(from.y, to.y) > minY && min(from.y, to.y) < maxY;
+	}
+	if(!near)
+		return 0;
+	
+	// Step the enemy alongside the bullet. Enemies added to the game before the bullet
+	// are updated before it, so have already taken their step when it is tested.
+	FrameStats* stats = _game->stats();
+	if(enemy->addOrder() < bullet->addOrder())
+	{
+		prevLoc = loc;
+		loc += enemy->velocityTowards(loc, targetLoc);
+	}
+	for(i = 0; i < maxFrames; i++)
+	{
+		stats->collisionTests++;
+		if(enemy->isOnScreen(loc))
+		{
+			Vec2 from = i > 0 ? _path[i - 1] : bullet->loc();
+			*time = Bullet::contactTime(from, _path[i], bullet->rules(), prevLoc, loc, enemy->rules());
+			if(*time >= 0)
+				return i + 1;
+		}
+		prevLoc = loc;
+		loc += enemy->velocityTowards(loc, targetLoc);
+	}
+	return 0;
+}
+
+/**
+ * Called by the game when an enemy enters the update loop, either by spawning or waking up.
+ * It will be checked against the standing predictions at the next refresh.
+ */
+void HitPredictor::enemyArrived(Enemy* enemy)
+{
+	if(_active)
+		_arrivedEnemies.push_back(enemy);
+}
+
+/**
+ * Called when an enemy is killed. Bullets that were headed for it go back to
+ * testing every frame until their paths are predicted again.
+ */
+void HitPredictor::enemyKilled(Enemy* enemy)
+{
+	if(!_active)
+		return;
+	vector<Bullet*>::iterator iter;
+	for(iter = _game->bulletsBegin(); iter != _game->bulletsEnd(); ++iter)
+	{
+		if((*iter)->predictedEnemy() == enemy)
+			(*iter)->clearPrediction();
+	}
+}
+
+/**
+ * Throws away every prediction. Bullets go back to testing every frame until
+ * their paths are predicted again.
+ */
+void HitPredictor::invalidateAll()
+{
+	vector<Bullet*>::iterator iter;
+	for(iter = _game->bulletsBegin(); iter != _game->bulletsEnd(); ++iter)
+		(*iter)->clearPrediction();
+	_arrivedEnemies.clear();
+}
+
+/**
+ * Returns whether hits are currently being predicted.
+ */
+bool HitPredictor::isActive()
+{
+	return _active;
+}
\ No newline at end of file
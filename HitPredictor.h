@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Vec2.h"
+
+class Game;
+class Bullet;
+class Enemy;
+
+/**
+ * Predicts which enemy each bullet will hit, and when, so that bullets don't
+ * have to be tested against every enemy every frame.
+ * While gravity holds steady and the players hold still, a bullet follows a fixed
+ * parabola and every enemy walks a fixed line, so a bullet's first hit can be found
+ * once and scheduled as an event on the game's timer wheel.
+ * Predictions are thrown away when gravity changes, a player moves or dies, or the
+ * enemy a bullet is headed for is killed first. Enemies that enter the game are
+ * checked against the predictions that are already standing.
+ * Bullets without a prediction test every enemy each frame as usual.
+ */
+class HitPredictor
+{
+private:
+	
+	Game* _game;
+	bool _active;
+	int _steadyFrames;
+	Vec2 _gravity;
+	vector<Enemy*> _arrivedEnemies;
+	vector<Vec2> _path;
+	
+	void tracePath(Bullet* bullet, int maxFrames);
+	void predict(Bullet* bullet, vector<Enemy*>::iterator begin, vector<Enemy*>::iterator end);
+	int firstContact(Bullet* bullet, Enemy* enemy, int maxFrames, float* time);
+	
+public:
+	
+	HitPredictor(Game* game);
+	
+	void reset();
+	
+	void refresh();
+	void enemyArrived(Enemy* enemy);
+	void enemyKilled(Enemy* enemy);
+	void invalidateAll();
+	bool isActive();
+};
\ No newline at end of file
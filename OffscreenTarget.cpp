@@ -0,0 +1,196 @@
+#include "OffscreenTarget.h"
+#include "rules.h"
+#include <math.h>
+
+/**
+ * Creates a target at RENDER_SCALE. Nothing is made until the first frame,
+ * once there's a GL context.
+ */
+OffscreenTarget::OffscreenTarget()
+{
+	_scale = RENDER_SCALE;
+	_drawScale = 1;
+	_windowScale = 1;
+	_framebuffer = 0;
+	_texture = 0;
+	_textureWidth = 0;
+	_textureHeight = 0;
+	_failed = false;
+	_oldFramebuffer = 0;
+	_oldViewport[0] = _oldViewport[1] = _oldViewport[2] = _oldViewport[3] = 0;
+}
+
+/**
+ * Sets the scale to draw at, as a fraction of the window's scale, so 1 draws
+ * at the window's own resolution. The scale drawn at, as a multiple of the
+ * logical screen size, is kept between RENDER_MIN_SCALE and the larger of 1
+ * and the window's scale.
+ */
+void OffscreenTarget::setScale(float scale)
+{
+	_scale = scale;
+}
+
+/**
+ * Returns the requested scale, as a fraction of the window's scale.
+ */
+float OffscreenTarget::scale()
+{
+	return _scale;
+}
+
+/**
+ * Returns the scale the latest frame was actually drawn at, as a multiple of
+ * the logical screen size.
+ */
+float OffscreenTarget::drawScale()
+{
+	return _drawScale;
+}
+
+/**
+ * Returns the scale at which the logical screen fills the window.
+ */
+float OffscreenTarget::windowScale()
+{
+	return _windowScale;
+}
+
+/**
+ * Returns the smallest power of two at least as big as the specified size,
+ * since OpenGL ES 1.1 textures must be powers of two.
+ */
+int OffscreenTarget::powerOfTwo(int size)
+{
+	int power = 1;
+	while(power < size)
+		power *= 2;
+	return power;
+}
+
+/**
+ * Makes the texture and the framebuffer that draws into it, big enough for
+ * the specified size, replacing any made before. Returns whether it worked.
+ */
+bool OffscreenTarget::allocate(int width, int height)
+{
+	if(_framebuffer != 0)
+	{
+		glDeleteFramebuffersOES(1, &_framebuffer);
+		glDeleteTextures(1, &_texture);
+	}
+	
+	_textureWidth = powerOfTwo(width);
+	_textureHeight = powerOfTwo(height);
+	glGenTextures(1, &_texture);
+	glBindTexture(GL_TEXTURE_2D, _texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, _textureWidth, _textureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	
+	glGenFramebuffersOES(1, &_framebuffer);
+	glBindFramebufferOES(GL_FRAMEBUFFER_OES, _framebuffer);
+	glFramebufferTexture2DOES(GL_FRAMEBUFFER_OES, GL_COLOR_ATTACHMENT0_OES, GL_TEXTURE_2D, _texture, 0);
+	bool complete = glCheckFramebufferStatusOES(GL_FRAMEBUFFER_OES) == GL_FRAMEBUFFER_COMPLETE_OES;
+	glBindFramebufferOES(GL_FRAMEBUFFER_OES, _oldFramebuffer);
+	return complete;
+}
+
+/**
+ * Starts drawing into the texture with the logical screen's coordinates,
+ * cleared to black. Returns false if the texture can't be drawn into, in
+ * which case the frame should be drawn straight to the window instead.
+ */
+bool OffscreenTarget::begin()
+{
+	if(_failed)
+		return false;
+	
+	// Fit the logical screen to the window.
+	float windowWidth = ofGetWidth();
+	float windowHeight = ofGetHeight();
+	_windowScale = min(windowWidth / SCREEN_WIDTH, windowHeight / SCREEN_HEIGHT);
+	_windowOffset = Vec2(windowWidth - SCREEN_WIDTH*_windowScale, windowHeight - SCREEN_HEIGHT*_windowScale) / 2;
+	float maxScale = max(_windowScale, 1.0f);
+	_drawScale = min(max(_scale * _windowScale, (float)RENDER_MIN_SCALE), maxScale);
+	
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING_OES, &_oldFramebuffer);
+	glGetIntegerv(GL_VIEWPORT, _oldViewport);
+	
+	int maxWidth = (int)ceil(SCREEN_WIDTH * maxScale);
+	int maxHeight = (int)ceil(SCREEN_HEIGHT * maxScale);
+	if(maxWidth > _textureWidth || maxHeight > _textureHeight)
+	{
+		if(!allocate(maxWidth, maxHeight))
+		{
+			_failed = true;
+			return false;
+		}
+	}
+	
+	glBindFramebufferOES(GL_FRAMEBUFFER_OES, _framebuffer);
+	glViewport(0, 0, (int)ceil(SCREEN_WIDTH * _drawScale), (int)ceil(SCREEN_HEIGHT * _drawScale));
+	glClearColor(0, 0, 0, 1);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glMatrixMode(GL_PROJECTION);
+	glPushMatrix();
+	glLoadIdentity();
+	glOrthof(0, SCREEN_WIDTH, SCREEN_HEIGHT, 0, -1, 1);
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+	glLoadIdentity();
+	return true;
+}
+
+/**
+ * Finishes drawing into the texture and stretches what was drawn over the
+ * window, without blending, since the window has just been cleared.
+ */
+void OffscreenTarget::end()
+{
+	glMatrixMode(GL_PROJECTION);
+	glPopMatrix();
+	glMatrixMode(GL_MODELVIEW);
+	glPopMatrix();
+	glBindFramebufferOES(GL_FRAMEBUFFER_OES, _oldFramebuffer);
+	glViewport(_oldViewport[0], _oldViewport[1], _oldViewport[2], _oldViewport[3]);
+	
+	// The texture's rows run bottom up, so its top is at the far end.
+	float right = ceil(SCREEN_WIDTH * _drawScale) / _textureWidth;
+	float top = ceil(SCREEN_HEIGHT * _drawScale) / _textureHeight;
+	Vec2 topLeft = _windowOffset;
+	Vec2 bottomRight = _windowOffset + Vec2(SCREEN_WIDTH, SCREEN_HEIGHT) * _windowScale;
+	GLfloat vertices[] = {
+		topLeft.x, topLeft.y,
+		bottomRight.x, topLeft.y,
+		topLeft.x, bottomRight.y,
+		bottomRight.x, bottomRight.y};
+	GLfloat texCoords[] = {0, top, right, top, 0, 0, right, 0};
+	
+	ofSetColor(255, 255, 255, 255);
+	glDisable(GL_BLEND);
+	glEnable(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, _texture);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glVertexPointer(2, GL_FLOAT, 0, vertices);
+	glTexCoordPointer(2, GL_FLOAT, 0, texCoords);
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glDisable(GL_TEXTURE_2D);
+	glEnable(GL_BLEND);
+}
+
+/**
+ * Converts a location in the window, such as a touch, to the logical screen
+ * the game is drawn in, as of the latest frame.
+ */
+Vec2 OffscreenTarget::toLogical(Vec2 windowLoc)
+{
+	return (windowLoc - _windowOffset) / _windowScale;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Vec2.h"
+
+/**
+ * A texture the game is drawn into at the logical SCREEN_WIDTH x SCREEN_HEIGHT
+ * size times a scale, and then stretched over the window, as large as fits
+ * without distorting it and centered, leaving black bars on the other sides.
+ * The scale is a fraction of the window's scale, so at 1 the texture matches
+ * the window pixel for pixel and looks just like drawing straight to it.
+ * Drawing at a lower scale trades sharpness for fill rate, which is most of
+ * what big alpha-blended circles cost.
+ * The texture is made big enough for the window's scale once, so changing the
+ * scale only changes how much of it is drawn into. Must be used on the thread
+ * that owns the GL context.
+ */
+class OffscreenTarget
+{
+private:
+	
+	float _scale; // The requested scale, as a fraction of the window's.
+	float _drawScale; // The scale the latest frame was drawn at.
+	float _windowScale; // The scale that fills the window.
+	Vec2 _windowOffset; // The window location of the logical screen's top left corner.
+	GLuint _framebuffer;
+	GLuint _texture;
+	int _textureWidth;
+	int _textureHeight;
+	bool _failed; // Whether the framebuffer couldn't be made.
+	GLint _oldFramebuffer;
+	GLint _oldViewport[4];
+	
+	bool allocate(int width, int height);
+	static int powerOfTwo(int size);
+
+public:
+	
+	OffscreenTarget();
+	
+	void setScale(float scale);
+	float scale();
+	float drawScale();
+	float windowScale();
+	
+	bool begin();
+	void end();
+	
+	Vec2 toLogical(Vec2 windowLoc);
+};
@@ -5,6 +5,11 @@
 #include "CircleEffect.h"
 #include "Bullet.h"
 #include "LevelBase.h"
+#include "HitPredictor.h"
+#include "Trace.h"
+#include "FastMath.h"
+#include "Snapshot.h"
+#include "RenderSnapshot.h"
 
 /**
  * Creates a new Player object to be placed in the game.
@@ -15,9 +20,61 @@ Player::Player(Game* game, PlayerRules* rules)
 	: GameObject(game)
 {
 	_rules = rules;
+	_path.build(rules->locs, rules->locCount, rules->speed);
+	_startFrame = game->frames();
 	_loc = rules->locs[0]; // Starting location is initial waypoint.
-	_targetLocIndex = 0;
 	_rot = rules->initRot;
+	
+	// Fire on every frame that is a multiple of the fire interval.
+	_fireDue = false;
+	_fireTimer = game->timers()->schedule((game->frames() / rules->fireInterval + 1) * rules->fireInterval, this, 0);
+}
+
+/**
+ * Recreates a player from the state written by save().
+ */
+Player::Player(Game* game, Snapshot* snapshot)
+	: GameObject(game)
+{
+	_rules = snapshot->read<PlayerRules*>();
+	_startFrame = snapshot->read<int>();
+	_loc = snapshot->read<Vec2>();
+	_rot = snapshot->read<float>();
+	_path.build(_rules->locs, _rules->locCount, _rules->speed);
+	
+	// Resume firing on the same multiples of the fire interval.
+	_fireDue = false;
+	_fireTimer = game->timers()->schedule((game->frames() / _rules->fireInterval + 1) * _rules->fireInterval, this, 0);
+}
+
+/**
+ * Writes this player's state to a snapshot.
+ * Between frames the player never has a shot waiting to be fired.
+ */
+void Player::save(Snapshot* snapshot)
+{
+	snapshot->write(_rules);
+	snapshot->write(_startFrame);
+	snapshot->write(_loc);
+	snapshot->write(_rot);
+}
+
+/**
+ * Cancels the fire timer when the player leaves the game.
+ */
+Player::~Player()
+{
+	_game->timers()->cancel(_fireTimer);
+}
+
+/**
+ * Called by the timer wheel at the start of each frame on which this player fires.
+ * The bullet is fired during update, once the player has moved.
+ */
+void Player::timerFired(int tag)
+{
+	_fireDue = true;
+	_fireTimer = _game->timers()->schedule(_game->frames() + _rules->fireInterval, this, 0);
 }
 
 /**
@@ -28,111 +85,95 @@ void Player::update()
 	// Rotate.
 	_rot += _rules->rotVel;
 	
-	// Move to next target?
-	ofPoint diff = targetLoc() - _loc;
-	if(fabs(diff.x) < 1 && fabs(diff.y) < 1)
-		_targetLocIndex++;
-	
-	// Move to target location.
-	float dist = sqrt(diff.x*diff.x + diff.y*diff.y);
-	if(dist > 0)
-	{
-		ofPoint normalized = diff / dist;
-		_loc += normalized * min(dist, _rules->speed);
-	}
+	// Move along the path.
+	_loc = locAtFrame(_game->frames());
 	
 	// Fire if enough time has elapsed.
-	if(_game->frames() % _rules->fireInterval == 0)
+	if(_fireDue)
 	{
-		float rad = ofDegToRad(_rot);
-		float cosRot = cos(rad);
-		float sinRot = sin(rad);
-		ofPoint vel = ofPoint(
-			_rules->fireVel.x * cosRot - _rules->fireVel.y * sinRot,
-			_rules->fireVel.x * sinRot + _rules->fireVel.y * cosRot);
+		_fireDue = false;
+		Vec2 vel = FastMath::rotate(_rules->fireVel, _rot);
 		Bullet* bullet = new Bullet(_game, _rules->bulletRules, _loc, vel);
 		_game->delayAddGameObject(shared_ptr<Bullet>(bullet));
 	}
 }
 
 /**
- * Called by the game to draw the bullet to the screen.
+ * Called by the game to record the player for drawing to the screen.
  */
-void Player::draw()
+void Player::render(RenderSnapshot* snapshot)
 {
-	ofPushStyle();
-	
 	// Draw outer circle.
-	ofSetColor(PLAYER_CIRCLE_R, PLAYER_CIRCLE_G, PLAYER_CIRCLE_B, PLAYER_CIRCLE_A);
-	ofNoFill();
-	ofCircle(_loc.x, _loc.y, PLAYER_CIRCLE_RAD);
-	
-	ofPushMatrix();
-	ofTranslate(_loc.x, _loc.y);
-	ofRotateZ(_rot);
+	snapshot->circle(_loc, PLAYER_CIRCLE_RAD, IntColor(PLAYER_CIRCLE_R, PLAYER_CIRCLE_G, PLAYER_CIRCLE_B, PLAYER_CIRCLE_A), false);
 	
-	// Draw inner triangle.
-	ofSetColor(PLAYER_TRIANGLE_R, PLAYER_TRIANGLE_G, PLAYER_TRIANGLE_B, PLAYER_TRIANGLE_A);
-	ofFill();
+	// Draw inner triangle, rotated about the player's location.
+	IntColor triangleColor(PLAYER_TRIANGLE_R, PLAYER_TRIANGLE_G, PLAYER_TRIANGLE_B, PLAYER_TRIANGLE_A);
 	float left = -PLAYER_TRIANGLE_WIDTH / 2;
 	float right = PLAYER_TRIANGLE_WIDTH / 2;
 	float top = -PLAYER_TRIANGLE_HEIGHT / 2;
 	float bottom = PLAYER_TRIANGLE_HEIGHT / 2;
-	ofTriangle(left, bottom, 0, top, right, bottom);
-	
-	ofPopMatrix();
+	snapshot->triangle(
+		_loc + FastMath::rotate(Vec2(left, bottom), _rot),
+		_loc + FastMath::rotate(Vec2(0, top), _rot),
+		_loc + FastMath::rotate(Vec2(right, bottom), _rot),
+		triangleColor);
 	
 	// Draw line of path.
 	int i;
 	for(i = 0; i < _rules->locCount; i++)
 	{
-		ofPoint loc1 = _rules->locs[i];
-		ofPoint loc2 = _rules->locs[(i+1) % _rules->locCount];
-		ofLine(loc1.x, loc1.y, loc2.x, loc2.y);
+		Vec2 loc1 = _rules->locs[i];
+		Vec2 loc2 = _rules->locs[(i+1) % _rules->locCount];
+		snapshot->line(loc1, loc2, triangleColor);
 	}
 	
-	ofPopStyle();
-	
 	// Draw predicted bullet path projection?
 	int ppa = _game->level()->pathProjectionAlpha(_game);
 	if(ppa > 0)
-		drawPathProjection(PATH_PROJECTION_R, PATH_PROJECTION_G, PATH_PROJECTION_B, PATH_PROJECTION_A * ppa / 255);
+		renderPathProjection(snapshot, PATH_PROJECTION_R, PATH_PROJECTION_G, PATH_PROJECTION_B, PATH_PROJECTION_A * ppa / 255);
 }
 
 /**
- * Draws a curved path showing the predicted path of the bullets.
+ * Records a curved path showing the predicted path of the bullets.
  * The rgba parameters are the color and alpha of the drawn curve.
  * The path will gradually fade out.
  */
-void Player::drawPathProjection(int r, int g, int b, int a)
+void Player::renderPathProjection(RenderSnapshot* snapshot, int r, int g, int b, int a)
 {
-	ofPushStyle();
-	
-	ofPoint lastLoc = _loc;
-	float rad = ofDegToRad(_rot);
-	float cosRot = cos(rad);
-	float sinRot = sin(rad);
-	ofPoint vel = ofPoint(
-		_rules->fireVel.x * cosRot - _rules->fireVel.y * sinRot,
-		_rules->fireVel.x * sinRot + _rules->fireVel.y * cosRot);
+	Vec2 lastLoc = _loc;
+	Vec2 vel = FastMath::rotate(_rules->fireVel, _rot);
 	int i;
-	int ppCount = _game->level()->pathProjectionCount(_game);
+	int ppCount = pathProjectionCount();
 	for(i = 0; i < ppCount; i++)
 	{
-		ofPoint curLoc = lastLoc + vel;
-		ofPoint rawAccel = ofxAccelerometer.getAccelOrientation();
-		ofPoint fixedAccel = ofPoint(rawAccel.x, -rawAccel.y);
-		vel += fixedAccel * _rules->bulletRules->gravityFactor;
+		Vec2 curLoc = lastLoc + vel;
+		vel += _game->gravity() * _rules->bulletRules->gravityFactor;
 		
 		float alphaFactor = (float)(ppCount - i) / ppCount;
-		ofSetColor(r, g, b, a * alphaFactor);
-
-		ofLine(lastLoc.x, lastLoc.y, curLoc.x, curLoc.y);
+		snapshot->line(lastLoc, curLoc, IntColor(r, g, b, (int)(a * alphaFactor)));
 		
 		lastLoc = curLoc;
 	}
-	
-	ofPopStyle();
+}
+
+/**
+ * Returns the number of steps of the path projection drawn at the current render quality.
+ */
+int Player::pathProjectionCount()
+{
+	return _game->level()->pathProjectionCount(_game) * _game->renderQuality()->pathProjection;
+}
+
+/**
+ * Returns the number of items render() records this frame: the outer circle,
+ * the triangle, the path, and, if shown, the path projection.
+ */
+int Player::renderItemCount()
+{
+	int count = 2 + _rules->locCount;
+	if(_game->level()->pathProjectionAlpha(_game) > 0)
+		count += pathProjectionCount();
+	return count;
 }
 
 /**
@@ -150,8 +191,12 @@ void Player::hit()
  */
 void Player::kill()
 {
+	TRACE_INSTANT("player killed");
 	_game->delayRemoveGameObject(this);
 	
+	// Enemies that were chasing this player will change course, or stop, this very frame.
+	_game->predictor()->invalidateAll();
+	
 	// If any one player dies, lose the game. Turns out the game is more fun this way.
 	_game->loseAtFrame(_game->frames() + LEVEL_LOSE_DELAY);
 	
@@ -170,6 +215,14 @@ void Player::kill()
 	_game->delayAddGameObject(shared_ptr<CircleEffect>(effect));
 }
 
+/**
+ * Returns whether this player will never move from its current location.
+ */
+bool Player::isStationary()
+{
+	return _path.isStationary();
+}
+
 /**
  * Returns the static rules governing this player's behavior.
  */
@@ -181,17 +234,19 @@ PlayerRules* Player::rules()
 /**
  * Returns the current location of this player.
  */
-ofPoint Player::loc()
+Vec2 Player::loc()
 {
 	return _loc;
 }
 
 /**
- * Returns the location of the player's next waypoint target.
+ * Returns where this player will be at the end of the specified frame.
+ * Players move along their paths regardless of anything else in the game,
+ * so this is valid for any frame from the one the player entered the game on.
  */
-ofPoint Player::targetLoc()
+Vec2 Player::locAtFrame(int frame)
 {
-	return _rules->locs[_targetLocIndex % _rules->locCount];
+	return _path.locAtFrame(frame - _startFrame);
 }
 
 /**
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "GameObject.h"
+#include "TimerWheel.h"
+#include "PlayerPath.h"
 
 struct BulletRules;
 
@@ -9,13 +11,13 @@ struct BulletRules;
  */
 struct PlayerRules
 {
-	ofPoint locs[12]; // Waypoints that the player will automatically follow.
+	Vec2* locs; // Waypoints that the player will automatically follow, looping back to the first.
 	int locCount; // Number of waypoints.
 	float speed; // The speed at which the player will travel between waypoints.
 	float initRot; // The initial rotation of the player.
 	float rotVel; // The initial rotational velocity of the player.
 	int fireInterval; // The interval between bullet spawns.
-	ofPoint fireVel; // The initial velocity of the fired bullets.
+	Vec2 fireVel; // The initial velocity of the fired bullets.
 	BulletRules* bulletRules; // The static rules for the fired bullets.
 };
 
@@ -23,29 +25,44 @@ struct PlayerRules
  * A single player "ship" in the game that moves and rotates along a
  * predefined path and fires bullets at a regular interval.
  */
-class Player : public GameObject
+class Player : public GameObject, public TimerListener
 {
 private:
 	
 	PlayerRules* _rules;
-	ofPoint _loc;
-	int _targetLocIndex;
+	Vec2 _loc;
+	PlayerPath _path;
+	int _startFrame;
 	float _rot;
+	TimerId _fireTimer;
+	bool _fireDue;
+	
+	int pathProjectionCount();
 	
 public:
 	
 	Player(Game* game, PlayerRules* rules);
+	Player(Game* game, Snapshot* snapshot);
+	virtual ~Player();
 	
 	void update();
-	void draw();
-	void drawPathProjection(int r, int g, int b, int a);
+	void timerFired(int tag);
+	void render(RenderSnapshot* snapshot);
+	void renderPathProjection(RenderSnapshot* snapshot, int r, int g, int b, int a);
+	
+	GameObjectType type(){return GAMEOBJECT_PLAYER;}
+	int renderItemCount();
+	RenderLayer renderLayer(){return RENDER_LAYER_PLAYERS;}
+	void save(Snapshot* snapshot);
 	
 	void hit();
 	void kill();
 	
+	bool isStationary();
+	
 	PlayerRules* rules();
-	ofPoint loc();
-	ofPoint targetLoc();
+	Vec2 loc();
+	Vec2 locAtFrame(int frame);
 	float rot();
 	
 	bool isPlayer(){return true;}
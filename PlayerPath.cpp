@@ -0,0 +1,96 @@
+#include "PlayerPath.h"
+
+// The number of lookup buckets per segment. Keeps the segment search to a step or two.
+#define BUCKETS_PER_SEGMENT 2
+
+/**
+ * Creates an empty path. Call build() before using it.
+ */
+PlayerPath::PlayerPath()
+{
+	_bucketLength = 0;
+	_speed = 0;
+}
+
+/**
+ * Measures the specified waypoints into a path.
+ * @param locs The waypoints, in the order they are visited.
+ * @param locCount The number of waypoints. At least one.
+ * @param speed The distance the player travels along the path each frame.
+ */
+void PlayerPath::build(const Vec2* locs, int locCount, float speed)
+{
+	_locs.assign(locs, locs + locCount);
+	_speed = speed;
+	
+	// Measure the cumulative length at the start of each segment.
+	_starts.resize(locCount + 1);
+	_starts[0] = 0;
+	int i;
+	for(i = 0; i < locCount; i++)
+	{
+		Vec2 diff = _locs[(i + 1) % locCount] - _locs[i];
+		_starts[i + 1] = _starts[i] + sqrt(diff.x*diff.x + diff.y*diff.y);
+	}
+	
+	// Split the path into equal stretches and note where each one starts.
+	int bucketCount = locCount * BUCKETS_PER_SEGMENT;
+	_buckets.resize(bucketCount);
+	_bucketLength = length() / bucketCount;
+	int segment = 0;
+	for(i = 0; i < bucketCount; i++)
+	{
+		float distance = i * _bucketLength;
+		while(segment + 1 < locCount && _starts[segment + 1] <= distance)
+			segment++;
+		_buckets[i] = segment;
+	}
+}
+
+/**
+ * Returns the location at the specified distance along the path from the first waypoint.
+ * @param distance At least 0 and less than the length of the path.
+ */
+Vec2 PlayerPath::locAtDistance(float distance)
+{
+	int locCount = _locs.size();
+	int bucket = min((int)(distance / _bucketLength), (int)_buckets.size() - 1);
+	int segment = _buckets[bucket];
+	while(segment + 1 < locCount && _starts[segment + 1] <= distance)
+		segment++;
+	
+	Vec2 start = _locs[segment];
+	Vec2 end = _locs[(segment + 1) % locCount];
+	float segmentLength = _starts[segment + 1] - _starts[segment];
+	if(segmentLength <= 0)
+		return start;
+	return start + (end - start) * ((distance - _starts[segment]) / segmentLength);
+}
+
+/**
+ * Returns the location of a player that has been following the path for the
+ * specified number of frames. Loops around the path as many times as needed.
+ */
+Vec2 PlayerPath::locAtFrame(int frames)
+{
+	if(isStationary())
+		return _locs[0];
+	double distance = fmod((double)frames * _speed, (double)length());
+	return locAtDistance(distance);
+}
+
+/**
+ * Returns the total length of the path, including the way back to the first waypoint.
+ */
+float PlayerPath::length()
+{
+	return _starts.back();
+}
+
+/**
+ * Returns whether a player following this path never moves.
+ */
+bool PlayerPath::isStationary()
+{
+	return _speed == 0 || length() == 0;
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Vec2.h"
+
+/**
+ * A player's waypoints measured by arc length, so that the player's location is a
+ * direct function of the number of frames it has been moving.
+ * The path is a closed loop: after the last waypoint the player heads back to the first.
+ * Built once when the player enters the game.
+ */
+class PlayerPath
+{
+private:
+	
+	vector<Vec2> _locs; // The waypoints. Segment i runs from waypoint i to the next one.
+	vector<float> _starts; // The distance along the path at which each segment starts, then the total length.
+	vector<int> _buckets; // The first segment touching each equal-length stretch of the path.
+	float _bucketLength;
+	float _speed;
+	
+public:
+	
+	PlayerPath();
+	
+	void build(const Vec2* locs, int locCount, float speed);
+	
+	Vec2 locAtDistance(float distance);
+	Vec2 locAtFrame(int frames);
+	float length();
+	bool isStationary();
+};
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "QualityScaler.h"
+#include "rules.h"
+#include <stdio.h>
+
+/**
+ * The quality levels, best first.
+ */
+static const RenderQuality qualityLevels[QUALITY_LEVEL_COUNT] =
+{
+	{1.0, 1, 1, 1.0},
+	{0.5, 2, 1, 0.85},
+	{0.5, 4, 2, 0.7},
+	{0.25, 0, 0, 0.5},
+};
+
+/**
+ * Creates a scaler at the best quality.
+ */
+QualityScaler::QualityScaler()
+{
+	_level = 0;
+	_averageMicros = 0;
+	_overFrames = 0;
+	_underFrames = 0;
+	_levelChanges = 0;
+}
+
+/**
+ * Called once a frame with how long it took, to step the quality down or up if needed.
+ */
+void QualityScaler::frameTook(long long micros)
+{
+	_averageMicros += (micros - _averageMicros) * QUALITY_SMOOTHING;
+	
+	float budget = 1000000.0f / SIM_TICK_RATE;
+	if(_averageMicros > budget * QUALITY_OVER_FRACTION)
+	{
+		_overFrames++;
+		_underFrames = 0;
+	}
+	else if(_averageMicros < budget * QUALITY_UNDER_FRACTION)
+	{
+		_underFrames++;
+		_overFrames = 0;
+	}
+	else
+	{
+		_overFrames = 0;
+		_underFrames = 0;
+	}
+	
+	if(_overFrames >= QUALITY_DOWN_FRAMES && _level < QUALITY_LEVEL_COUNT - 1)
+	{
+		_level++;
+		_levelChanges++;
+		_overFrames = 0;
+	}
+	else if(_underFrames >= QUALITY_UP_FRAMES && _level > 0)
+	{
+		_level--;
+		_levelChanges++;
+		_underFrames = 0;
+	}
+}
+
+/**
+ * Returns the current quality level, where 0 is the best.
+ */
+int QualityScaler::level()
+{
+	return _level;
+}
+
+/**
+ * Returns the smoothed frame time, in microseconds.
+ */
+float QualityScaler::averageMicros()
+{
+	return _averageMicros;
+}
+
+/**
+ * Prints the current level and how often it has changed.
+ */
+void QualityScaler::print()
+{
+	printf("quality: level %d, %d changes, frames averaging %.0fus\n", _level, _levelChanges, _averageMicros);
+}
+
+/**
+ * Returns what the specified quality level draws.
+ */
+const RenderQuality* QualityScaler::quality(int level)
+{
+	return &qualityLevels[level];
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+/**
+ * What a quality level draws. Every setting only changes what is drawn,
+ * never what is simulated, so a game plays out the same at every level.
+ */
+struct RenderQuality
+{
+	float pathProjection; // The fraction of the path projection's steps to draw.
+	int dustStride; // Draw one dust particle in this many, or none if 0.
+	int minorEffectStride; // Draw one small effect in this many, or none if 0.
+	float renderScale; // The fraction of RENDER_SCALE to draw the screen at.
+};
+
+/**
+ * Watches how long frames take and steps down through the quality levels while
+ * they run over budget, and back up once they have been well under it for a while.
+ * The frame time is smoothed, a level is only left after QUALITY_DOWN_FRAMES frames
+ * over budget or QUALITY_UP_FRAMES frames well under it, and the gap between the
+ * two thresholds keeps a frame time near the budget from flipping back and forth.
+ */
+class QualityScaler
+{
+private:
+	
+	int _level;
+	float _averageMicros;
+	int _overFrames; // Frames in a row over QUALITY_OVER_FRACTION of the budget.
+	int _underFrames; // Frames in a row under QUALITY_UNDER_FRACTION of the budget.
+	int _levelChanges;
+
+public:
+	
+	QualityScaler();
+	
+	void frameTook(long long micros);
+	
+	int level();
+	float averageMicros();
+	void print();
+	
+	static const RenderQuality* quality(int level);
+};
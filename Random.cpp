@@ -0,0 +1,45 @@
+#include "Random.h"
+
+/**
+ * Creates a new generator from the specified seed.
+ * Zero would get the generator stuck, so it is replaced.
+ */
+Random::Random(unsigned int seed)
+{
+	setState(seed);
+}
+
+/**
+ * Returns the next 32 random bits.
+ */
+unsigned int Random::next()
+{
+	_state ^= _state << 13;
+	_state ^= _state >> 17;
+	_state ^= _state << 5;
+	return _state;
+}
+
+/**
+ * Returns a random integer at least 0 and less than n.
+ */
+int Random::nextInt(int n)
+{
+	return next() % n;
+}
+
+/**
+ * Returns the generator's state, from which it can be resumed with setState.
+ */
+unsigned int Random::state()
+{
+	return _state;
+}
+
+/**
+ * Resumes the generator from a state returned by state().
+ */
+void Random::setState(unsigned int state)
+{
+	_state = state != 0 ? state : 0x9e3779b9;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+/**
+ * A small, fast pseudo-random number generator whose whole state is one integer,
+ * so that it can be saved in a game snapshot and replayed exactly.
+ * Uses Marsaglia's xorshift32.
+ */
+class Random
+{
+private:
+	
+	unsigned int _state;
+
+public:
+	
+	Random(unsigned int seed=1);
+	
+	unsigned int next();
+	int nextInt(int n);
+	
+	unsigned int state();
+	void setState(unsigned int state);
+};
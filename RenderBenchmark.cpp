@@ -0,0 +1,91 @@
+#include "RenderBenchmark.h"
+#include "Game.h"
+#include "GenericLevel.h"
+#include "GravityPolicy.h"
+#include "RenderSnapshot.h"
+#include "Stopwatch.h"
+#include "rules.h"
+
+/**
+ * Creates a benchmark.
+ * @param level The 1-based number of the level to play.
+ * @param frames The number of frames to play and draw.
+ * @param sorted Whether to sort each snapshot before drawing it.
+ */
+RenderBenchmark::RenderBenchmark(int level, int frames, bool sorted)
+	: _renderer(SCREEN_WIDTH, SCREEN_HEIGHT)
+{
+	_level = level;
+	_frames = frames;
+	_sorted = sorted;
+	_recordMicros = 0;
+	_sortMicros = 0;
+	_rasterMicros = 0;
+	_primitives = 0;
+	_stateChanges = 0;
+	_pixelsBlended = 0;
+	_checksum = 0;
+}
+
+/**
+ * Plays and draws every frame.
+ * @param imagePath The file to save the last frame to as a PPM, or NULL not to save it.
+ */
+void RenderBenchmark::run(const char* imagePath)
+{
+	Game game(NULL, shared_ptr<LevelBase>(new GenericLevel(levels[_level - 1])), RENDER_BENCH_SEED);
+	ScriptedGravity* policy = ScriptedGravity::turning(TUNING_GRAVITY_HOLD_FRAMES, TUNING_GRAVITY_MAX);
+	game.setGravityPolicy(shared_ptr<GravityPolicy>(policy));
+	
+	RenderSnapshot snapshot;
+	int i;
+	for(i = 0; i < _frames; i++)
+	{
+		game.update();
+		
+		Stopwatch recordStopwatch;
+		snapshot.clear();
+		game.render(&snapshot);
+		_recordMicros += recordStopwatch.elapsedMicros();
+		
+		if(_sorted)
+		{
+			Stopwatch sortStopwatch;
+			snapshot.sort();
+			_sortMicros += sortStopwatch.elapsedMicros();
+		}
+		
+		Stopwatch rasterStopwatch;
+		snapshot.draw(&_renderer);
+		_rasterMicros += rasterStopwatch.elapsedMicros();
+		
+		_primitives += _renderer.stats()->primitives;
+		_stateChanges += _renderer.stats()->stateChanges;
+		_pixelsBlended += _renderer.pixelsBlended();
+	}
+	
+	_checksum = _renderer.checksum();
+	if(imagePath != NULL && !_renderer.save(imagePath))
+		printf("render: could not write %s\n", imagePath);
+}
+
+/**
+ * Prints the per-frame averages and the checksum of the last frame.
+ */
+void RenderBenchmark::print()
+{
+	float frames = max(_frames, 1);
+	printf("render: level %d, %d frames, %s, record %.1fus sort %.1fus raster %.1fus, "
+		   "%.1f primitives %.1f state changes %.0f pixels per frame, checksum %016llx\n",
+		   _level, _frames, _sorted ? "sorted" : "unsorted",
+		   _recordMicros / frames, _sortMicros / frames, _rasterMicros / frames,
+		   _primitives / frames, _stateChanges / frames, _pixelsBlended / frames, _checksum);
+}
+
+/**
+ * Returns the checksum of the last frame drawn. Valid once run() has returned.
+ */
+unsigned long long RenderBenchmark::checksum()
+{
+	return _checksum;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "SoftwareRenderer.h"
+
+/**
+ * Plays a level headlessly with scripted gravity and draws every frame with a
+ * SoftwareRenderer, measuring the cost of recording the frames into snapshots
+ * and of rasterizing them, and counting what they draw. Snapshots can be
+ * drawn sorted or as recorded, to see what sorting saves.
+ * The game is seeded, so the same level and frame count always end on the
+ * same image; its checksum can be compared with a known-good one.
+ */
+class RenderBenchmark
+{
+private:
+	
+	int _level;
+	int _frames;
+	bool _sorted;
+	SoftwareRenderer _renderer;
+	long long _recordMicros;
+	long long _sortMicros;
+	long long _rasterMicros;
+	long long _primitives;
+	long long _stateChanges;
+	long long _pixelsBlended;
+	unsigned long long _checksum;
+
+public:
+	
+	RenderBenchmark(int level, int frames, bool sorted);
+	
+	void run(const char* imagePath=NULL);
+	void print();
+	
+	unsigned long long checksum();
+};
@@ -0,0 +1,58 @@
+#include "RenderBuffer.h"
+
+// Marks the waiting snapshot as published since the reader last took one.
+#define RENDER_BUFFER_FRESH 4
+#define RENDER_BUFFER_INDEX_MASK 3
+
+/**
+ * Creates a buffer whose snapshots are all empty.
+ */
+RenderBuffer::RenderBuffer()
+{
+	_writing = 0;
+	_waiting = 1;
+	_reading = 2;
+}
+
+/**
+ * Atomically replaces the waiting snapshot and returns the previous one.
+ * The exchange is a full memory barrier, so everything written to a snapshot
+ * before it is handed over is seen by the thread that receives it.
+ */
+int RenderBuffer::exchangeWaiting(int waiting)
+{
+	int old = __sync_fetch_and_add(&_waiting, 0);
+	int seen;
+	while((seen = __sync_val_compare_and_swap(&_waiting, old, waiting)) != old)
+		old = seen;
+	return old;
+}
+
+/**
+ * Returns the snapshot to record the next frame into. Called by the writer only.
+ * It holds whatever was recorded into it last; clear it first.
+ */
+RenderSnapshot* RenderBuffer::writing()
+{
+	return &_snapshots[_writing];
+}
+
+/**
+ * Makes the snapshot returned by writing() the latest one and gives the writer
+ * another snapshot to write. Called by the writer only.
+ */
+void RenderBuffer::publish()
+{
+	_writing = exchangeWaiting(_writing | RENDER_BUFFER_FRESH) & RENDER_BUFFER_INDEX_MASK;
+}
+
+/**
+ * Returns the latest published snapshot, which stays unchanged until the next call.
+ * Called by the reader only.
+ */
+RenderSnapshot* RenderBuffer::latest()
+{
+	if(__sync_fetch_and_add(&_waiting, 0) & RENDER_BUFFER_FRESH)
+		_reading = exchangeWaiting(_reading) & RENDER_BUFFER_INDEX_MASK;
+	return &_snapshots[_reading];
+}
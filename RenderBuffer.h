@@ -0,0 +1,35 @@
+#pragma once
+
+#include "RenderSnapshot.h"
+
+/**
+ * Hands RenderSnapshots from the simulation thread to the drawing thread
+ * through three snapshots that take turns: one being written, one being drawn,
+ * and the newest finished one waiting in between.
+ * Neither side ever waits for the other. Publishing swaps the written snapshot
+ * with the waiting one, and taking the latest swaps the drawn snapshot with the
+ * waiting one if it is newer; each swap is a single atomic exchange.
+ * If the simulation publishes faster than frames are drawn, the skipped snapshots
+ * are simply overwritten; if slower, the same snapshot is drawn again.
+ * Exactly one thread may write and one thread may draw.
+ */
+class RenderBuffer
+{
+private:
+	
+	RenderSnapshot _snapshots[3];
+	int _writing; // The snapshot being written. Owned by the writer.
+	int _reading; // The snapshot being drawn. Owned by the reader.
+	volatile int _waiting; // The snapshot in between, plus RENDER_BUFFER_FRESH if not yet taken.
+	
+	int exchangeWaiting(int waiting);
+
+public:
+	
+	RenderBuffer();
+	
+	RenderSnapshot* writing();
+	void publish();
+	
+	RenderSnapshot* latest();
+};
@@ -0,0 +1,78 @@
+#include "RenderJob.h"
+#include "Game.h"
+#include "Trace.h"
+
+/**
+ * Creates a job that does nothing until setup() is called.
+ */
+RenderJob::RenderJob()
+{
+	_game = NULL;
+	_begin = 0;
+	_end = 0;
+	_itemCount = 0;
+	_target = NULL;
+	_first = 0;
+}
+
+/**
+ * Points this job at a chunk of objects, to be counted when it next runs.
+ * @param game The game being recorded.
+ * @param begin The index of the first GameObject of the chunk.
+ * @param end The index just past the last GameObject of the chunk.
+ */
+void RenderJob::setup(Game* game, int begin, int end)
+{
+	_game = game;
+	_begin = begin;
+	_end = end;
+	_itemCount = 0;
+	_target = NULL;
+	_first = 0;
+}
+
+/**
+ * Makes the job record its chunk when it next runs, rather than count it.
+ * @param target The snapshot to record into.
+ * @param first The first of the itemCount() items reserved in it for the chunk.
+ */
+void RenderJob::recordInto(RenderSnapshot* target, int first)
+{
+	_target = target;
+	_first = first;
+}
+
+/**
+ * Counts the chunk's items or records them, each object in its own layer.
+ * Either way it only reads the game.
+ */
+void RenderJob::run()
+{
+	TRACE_SCOPE("RenderJob::run");
+	GameObjectIter gobjects = _game->gameObjectsBegin();
+	int i;
+	if(_target == NULL)
+	{
+		_itemCount = 0;
+		for(i = _begin; i < _end; i++)
+			_itemCount += gobjects[i]->renderItemCount();
+		return;
+	}
+	
+	_range.recordInto(_target, _first);
+	for(i = _begin; i < _end; i++)
+	{
+		GameObject* gobject = gobjects[i].get();
+		_range.setLayer(gobject->renderLayer());
+		gobject->render(&_range);
+	}
+	_range.recordInto(NULL, 0);
+}
+
+/**
+ * Returns the number of items the chunk records, as of the latest count.
+ */
+int RenderJob::itemCount()
+{
+	return _itemCount;
+}
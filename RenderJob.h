@@ -0,0 +1,36 @@
+#pragma once
+
+#include "ThreadPool.h"
+#include "RenderSnapshot.h"
+
+class Game;
+
+/**
+ * Records one chunk of a game's objects straight into a run of items reserved
+ * for it in the frame's snapshot, so that many chunks can be recorded at once
+ * without sharing anything. A job is run twice a frame: first to count the
+ * items its chunk records, so the game can reserve the runs in chunk order,
+ * and then to record them.
+ */
+class RenderJob : public Job
+{
+private:
+	
+	Game* _game;
+	int _begin;
+	int _end;
+	int _itemCount; // The number of items the chunk records, once counted.
+	RenderSnapshot* _target; // The snapshot to record into, or NULL to count.
+	int _first; // The first item of _target reserved for the chunk.
+	RenderSnapshot _range; // Fills in the reserved items.
+
+public:
+	
+	RenderJob();
+	
+	void setup(Game* game, int begin, int end);
+	void recordInto(RenderSnapshot* target, int first);
+	void run();
+	
+	int itemCount();
+};
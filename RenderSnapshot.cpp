@@ -0,0 +1,411 @@
+#include "RenderSnapshot.h"
+#include "Renderer.h"
+#include <string.h>
+
+// An item's sort key is its layer above its position in the snapshot.
+#define RENDER_KEY_LAYER_SHIFT 61
+#define RENDER_KEY_INDEX_MASK ((1ULL << RENDER_KEY_LAYER_SHIFT) - 1)
+
+/**
+ * Creates an empty snapshot.
+ */
+RenderSnapshot::RenderSnapshot()
+{
+	_layer = RENDER_LAYER_BACKGROUND;
+	_sorted = false;
+	_rangeTarget = NULL;
+	_rangeNext = 0;
+	_frame = 0;
+	_changes = 0;
+	_moves = 0;
+	_tickMicros = 0;
+}
+
+/**
+ * Removes every item, keeping the memory for the next frame.
+ */
+void RenderSnapshot::clear()
+{
+	_items.clear();
+	_texts.clear();
+	_points.clear();
+	_keys.clear();
+	_layer = RENDER_LAYER_BACKGROUND;
+	_sorted = false;
+	_frame = 0;
+	_changes = 0;
+	_moves = 0;
+	_tickMicros = 0;
+}
+
+/**
+ * Sets the number of the game frame this snapshot shows.
+ */
+void RenderSnapshot::setFrame(int frame)
+{
+	_frame = frame;
+}
+
+/**
+ * Returns the number of the game frame this snapshot shows.
+ */
+int RenderSnapshot::frame()
+{
+	return _frame;
+}
+
+/**
+ * Sets the layer of the items added after this.
+ */
+void RenderSnapshot::setLayer(RenderLayer layer)
+{
+	_layer = layer;
+}
+
+/**
+ * Appends an item of the specified type and color and returns it for filling in,
+ * or, while recording into another snapshot, takes its next reserved item instead.
+ */
+RenderItem* RenderSnapshot::addItem(RenderItemType type, IntColor color)
+{
+	RenderItem* item;
+	if(_rangeTarget != NULL)
+	{
+		item = &_rangeTarget->_items[_rangeNext++];
+	}
+	else
+	{
+		_items.push_back(RenderItem());
+		item = &_items.back();
+	}
+	item->type = type;
+	item->layer = _layer;
+	item->radius = 0;
+	item->filled = true;
+	item->color = color;
+	item->text = -1;
+	item->points = -1;
+	item->pointCount = 0;
+	return item;
+}
+
+/**
+ * Adds a circle.
+ * @param filled Whether to fill the circle or only draw its outline.
+ */
+void RenderSnapshot::circle(Vec2 loc, float radius, IntColor color, bool filled)
+{
+	RenderItem* item = addItem(RENDER_CIRCLE, color);
+	item->a = loc;
+	item->radius = radius;
+	item->filled = filled;
+}
+
+/**
+ * Adds a line.
+ */
+void RenderSnapshot::line(Vec2 start, Vec2 end, IntColor color)
+{
+	RenderItem* item = addItem(RENDER_LINE, color);
+	item->a = start;
+	item->b = end;
+}
+
+/**
+ * Adds a filled triangle.
+ */
+void RenderSnapshot::triangle(Vec2 a, Vec2 b, Vec2 c, IntColor color)
+{
+	RenderItem* item = addItem(RENDER_TRIANGLE, color);
+	item->a = a;
+	item->b = b;
+	item->c = c;
+}
+
+/**
+ * Adds a string, copying it. Strings longer than the snapshot holds are cut short.
+ * @param font The font to draw the string in.
+ * @param loc The point the string is rotated about.
+ * @param deg The rotation of the string, in degrees.
+ * @param centered Whether to center the string on loc rather than start it there.
+ * @param lineOffset When centered, the number of line heights to move the string down.
+ */
+void RenderSnapshot::text(const char* text, RenderFont font, Vec2 loc, float deg, IntColor color, bool centered, float lineOffset)
+{
+	_texts.push_back(RenderText());
+	RenderText& renderText = _texts.back();
+	strncpy(renderText.text, text, sizeof(renderText.text) - 1);
+	renderText.text[sizeof(renderText.text) - 1] = '\0';
+	renderText.font = font;
+	renderText.loc = loc;
+	renderText.deg = deg;
+	renderText.centered = centered;
+	renderText.lineOffset = lineOffset;
+	
+	RenderItem* item = addItem(RENDER_TEXT, color);
+	item->text = _texts.size() - 1;
+}
+
+/**
+ * Adds a batch of filled circles, all the same size and color, to be drawn in one go.
+ * Returns where to write the centers of the circles, valid until anything else is added.
+ * The count must be at least 1.
+ */
+Vec2* RenderSnapshot::points(int count, float radius, IntColor color)
+{
+	RenderItem* item = addItem(RENDER_POINTS, color);
+	item->radius = radius;
+	item->points = _points.size();
+	item->pointCount = count;
+	_points.resize(_points.size() + count);
+	return &_points[item->points];
+}
+
+/**
+ * Returns the number of items in this snapshot.
+ */
+int RenderSnapshot::itemCount()
+{
+	return _items.size();
+}
+
+/**
+ * Adds the specified number of items, to be filled in by recordInto(), and
+ * returns the index of the first. Until they're filled in they're undefined.
+ */
+int RenderSnapshot::reserve(int count)
+{
+	int first = _items.size();
+	_items.resize(first + count);
+	return first;
+}
+
+/**
+ * Makes the circles, lines, and triangles added to this snapshot from now on
+ * fill in the items of the specified snapshot reserved from the specified index,
+ * in order, instead of being added here. Each filled-in item gets this snapshot's layer.
+ * Exactly as many must be added as the caller set aside for them. Texts and points
+ * can't be recorded this way. Other snapshots may fill in other items of the
+ * same target at the same time, since nothing but their own items is touched.
+ * @param target The snapshot to fill in, or NULL to go back to adding items here.
+ */
+void RenderSnapshot::recordInto(RenderSnapshot* target, int first)
+{
+	_rangeTarget = target;
+	_rangeNext = first;
+}
+
+/**
+ * Counts how many items differ from those of the previous snapshot, position
+ * by position, counting any extra or missing items as changed too. Of those,
+ * it also counts the moves: the items outside the dust that moved, appeared,
+ * or disappeared, rather than only changing color while staying visible.
+ * @param previous The snapshot published before this one, or NULL if there wasn't one.
+ */
+void RenderSnapshot::compare(const RenderSnapshot* previous)
+{
+	_changes = 0;
+	_moves = 0;
+	int count = previous != NULL ? min(_items.size(), previous->_items.size()) : 0;
+	int i;
+	for(i = 0; i < count; i++)
+	{
+		const RenderItem& item = _items[i];
+		const RenderItem& previousItem = previous->_items[i];
+		if(sameItem(item, *previous, previousItem))
+			continue;
+		_changes++;
+		if(item.layer == RENDER_LAYER_DUST && previousItem.layer == RENDER_LAYER_DUST)
+			continue;
+		IntColor color = item.color;
+		IntColor previousColor = previousItem.color;
+		if(!sameShape(item, *previous, previousItem) || color.a() == 0 || previousColor.a() == 0)
+			_moves++;
+	}
+	
+	// Extra or missing items.
+	for(i = count; i < (int)_items.size(); i++)
+		countAppeared(_items[i]);
+	if(previous != NULL)
+	{
+		for(i = count; i < (int)previous->_items.size(); i++)
+			countAppeared(previous->_items[i]);
+	}
+}
+
+/**
+ * Counts an item that is in only one of the snapshots compared as a change,
+ * and, unless it's dust, as a move.
+ */
+void RenderSnapshot::countAppeared(const RenderItem& item)
+{
+	_changes++;
+	if(item.layer != RENDER_LAYER_DUST)
+		_moves++;
+}
+
+/**
+ * Returns whether an item looks exactly like an item of another snapshot.
+ */
+bool RenderSnapshot::sameItem(const RenderItem& item, const RenderSnapshot& other, const RenderItem& otherItem) const
+{
+	IntColor color = item.color;
+	IntColor otherColor = otherItem.color;
+	return (int32)color == (int32)otherColor && sameShape(item, other, otherItem);
+}
+
+/**
+ * Returns whether an item is drawn in the same place as an item of another
+ * snapshot, with the same shape and contents, though maybe in another color.
+ */
+bool RenderSnapshot::sameShape(const RenderItem& item, const RenderSnapshot& other, const RenderItem& otherItem) const
+{
+	if(item.type != otherItem.type || item.layer != otherItem.layer || item.filled != otherItem.filled)
+		return false;
+	if(item.a != otherItem.a || item.b != otherItem.b || item.c != otherItem.c || item.radius != otherItem.radius)
+		return false;
+	if(item.type == RENDER_POINTS)
+	{
+		return item.pointCount == otherItem.pointCount
+			&& equal(&_points[item.points], &_points[item.points] + item.pointCount, &other._points[otherItem.points]);
+	}
+	if(item.type != RENDER_TEXT)
+		return true;
+	
+	const RenderText& text = _texts[item.text];
+	const RenderText& otherText = other._texts[otherItem.text];
+	return strcmp(text.text, otherText.text) == 0 && text.font == otherText.font
+		&& text.loc == otherText.loc && text.deg == otherText.deg
+		&& text.centered == otherText.centered && text.lineOffset == otherText.lineOffset;
+}
+
+/**
+ * Returns the number of items that changed since the previous snapshot, as of compare().
+ */
+int RenderSnapshot::changes()
+{
+	return _changes;
+}
+
+/**
+ * Returns the number of items outside the dust that moved, appeared, or
+ * disappeared since the previous snapshot, as of compare().
+ */
+int RenderSnapshot::moves()
+{
+	return _moves;
+}
+
+/**
+ * Sets how long the tick that recorded this snapshot took, in microseconds.
+ */
+void RenderSnapshot::setTickMicros(long long micros)
+{
+	_tickMicros = micros;
+}
+
+/**
+ * Returns how long the tick that recorded this snapshot took, in microseconds.
+ */
+long long RenderSnapshot::tickMicros()
+{
+	return _tickMicros;
+}
+
+/**
+ * Orders the items for drawing by radix sorting a key for each, made of its
+ * layer and then its position in the snapshot, so the layers are drawn bottom
+ * first and each keeps the order its items were added in. Blending one
+ * translucent color over another gives a different result from the other way
+ * round, so items within a layer are never reordered, and the only state changes
+ * saved are between neighbors that already share their state. Everything is
+ * drawn alpha blended, so there's no blend mode to sort by.
+ */
+void RenderSnapshot::sort()
+{
+	int count = _items.size();
+	_keys.resize(count);
+	int i;
+	for(i = 0; i < count; i++)
+		_keys[i] = (unsigned long long)_items[i].layer << RENDER_KEY_LAYER_SHIFT | (unsigned long long)i;
+	
+	// Sort a byte at a time from the lowest, skipping bytes every key shares.
+	_sortBuffer.resize(count);
+	int counts[256];
+	int shift;
+	for(shift = 0; shift < 64 && count > 1; shift += 8)
+	{
+		memset(counts, 0, sizeof(counts));
+		for(i = 0; i < count; i++)
+			counts[(_keys[i] >> shift) & 0xff]++;
+		if(counts[(_keys[0] >> shift) & 0xff] == count)
+			continue;
+		
+		int offset = 0;
+		int digit;
+		for(digit = 0; digit < 256; digit++)
+		{
+			int digitCount = counts[digit];
+			counts[digit] = offset;
+			offset += digitCount;
+		}
+		for(i = 0; i < count; i++)
+			_sortBuffer[counts[(_keys[i] >> shift) & 0xff]++] = _keys[i];
+		_keys.swap(_sortBuffer);
+	}
+	_sorted = true;
+}
+
+/**
+ * Draws every item with the specified renderer, in sorted order if the
+ * snapshot has been sorted or else in the order they were added.
+ */
+void RenderSnapshot::draw(Renderer* renderer)
+{
+	renderer->begin();
+	if(_sorted)
+	{
+		vector<unsigned long long>::iterator iter;
+		for(iter = _keys.begin(); iter != _keys.end(); ++iter)
+			drawItem(renderer, _items[*iter & RENDER_KEY_INDEX_MASK]);
+	}
+	else
+	{
+		vector<RenderItem>::iterator iter;
+		for(iter = _items.begin(); iter != _items.end(); ++iter)
+			drawItem(renderer, *iter);
+	}
+	renderer->end();
+}
+
+/**
+ * Draws a single item with the specified renderer.
+ */
+void RenderSnapshot::drawItem(Renderer* renderer, const RenderItem& item)
+{
+	renderer->setColor(item.color);
+	switch(item.type)
+	{
+		case RENDER_CIRCLE:
+			renderer->setFilled(item.filled);
+			if(item.filled && renderer->covers(item.a, item.radius))
+				renderer->fill();
+			else
+				renderer->circle(item.a, item.radius);
+			break;
+		case RENDER_LINE:
+			renderer->line(item.a, item.b);
+			break;
+		case RENDER_TRIANGLE:
+			renderer->setFilled(true);
+			renderer->triangle(item.a, item.b, item.c);
+			break;
+		case RENDER_TEXT:
+			renderer->text(_texts[item.text]);
+			break;
+		case RENDER_POINTS:
+			renderer->setFilled(true);
+			renderer->points(&_points[item.points], item.pointCount, item.radius);
+			break;
+	}
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "Vec2.h"
+#include "IntColor.h"
+
+class Renderer;
+
+/**
+ * The kinds of shapes a RenderSnapshot can hold.
+ */
+enum RenderItemType
+{
+	RENDER_CIRCLE, // A circle at point a with the item's radius, filled or not.
+	RENDER_LINE, // A line from point a to point b.
+	RENDER_TRIANGLE, // A filled triangle with corners a, b, and c.
+	RENDER_TEXT, // One of the snapshot's texts.
+	RENDER_POINTS // Filled circles with the item's radius at a run of the snapshot's points.
+};
+
+/**
+ * The layers a RenderSnapshot draws, bottom first. Whatever is in a higher layer
+ * is drawn over everything in the lower ones; within a layer, items are drawn
+ * in the order they were added.
+ * The layers follow the order the game adds its objects in: dust at setup,
+ * then the players, the enemies, the players' bullets, and effects on top.
+ */
+enum RenderLayer
+{
+	RENDER_LAYER_BACKGROUND, // The level instructions and the gravity arrow.
+	RENDER_LAYER_DUST,
+	RENDER_LAYER_PLAYERS,
+	RENDER_LAYER_ENEMIES,
+	RENDER_LAYER_BULLETS,
+	RENDER_LAYER_EFFECTS,
+	RENDER_LAYER_OVERLAY // Text over everything, such as the level number.
+};
+
+/**
+ * The fonts the application loads, for texts in a RenderSnapshot.
+ */
+enum RenderFont
+{
+	RENDER_FONT_SMALL,
+	RENDER_FONT_BIG
+};
+
+/**
+ * A single shape to draw, in screen coordinates.
+ */
+struct RenderItem
+{
+	RenderItemType type;
+	RenderLayer layer;
+	Vec2 a;
+	Vec2 b;
+	Vec2 c;
+	float radius;
+	bool filled;
+	IntColor color;
+	int text; // For RENDER_TEXT, the index of the text in the snapshot.
+	int points; // For RENDER_POINTS, the index of the first point in the snapshot.
+	int pointCount; // For RENDER_POINTS, the number of points.
+};
+
+/**
+ * A string to draw, rotated about its location.
+ */
+struct RenderText
+{
+	char text[128];
+	RenderFont font;
+	Vec2 loc;
+	float deg; // The rotation about loc, in degrees.
+	bool centered; // Whether the string is centered on loc rather than starting at it.
+	float lineOffset; // When centered, the number of line heights to move the string down.
+};
+
+/**
+ * Everything one frame of the game draws, recorded by the simulation
+ * so that it can be drawn later on another thread.
+ * A snapshot owns copies of all its data and refers to no game objects,
+ * so it stays valid however the game changes after it is recorded.
+ * Items are drawn in the order they were added until the snapshot is sorted,
+ * after which they're drawn layer by layer.
+ * A run of items can be reserved and then filled in later through other snapshots,
+ * one for each part of the run, so that many threads can record into one snapshot.
+ */
+class RenderSnapshot
+{
+private:
+	
+	vector<RenderItem> _items;
+	vector<RenderText> _texts;
+	vector<Vec2> _points;
+	vector<unsigned long long> _keys; // Once sorted, the sort key of each item in drawing order.
+	vector<unsigned long long> _sortBuffer;
+	RenderLayer _layer;
+	bool _sorted;
+	RenderSnapshot* _rangeTarget; // The snapshot whose reserved items are being filled in, or NULL.
+	int _rangeNext; // The next reserved item of _rangeTarget to fill in.
+	int _frame;
+	int _changes;
+	int _moves;
+	long long _tickMicros;
+	
+	RenderItem* addItem(RenderItemType type, IntColor color);
+	void drawItem(Renderer* renderer, const RenderItem& item);
+	void countAppeared(const RenderItem& item);
+	bool sameItem(const RenderItem& item, const RenderSnapshot& other, const RenderItem& otherItem) const;
+	bool sameShape(const RenderItem& item, const RenderSnapshot& other, const RenderItem& otherItem) const;
+
+public:
+	
+	RenderSnapshot();
+	
+	void clear();
+	void setFrame(int frame);
+	int frame();
+	void setLayer(RenderLayer layer);
+	
+	void circle(Vec2 loc, float radius, IntColor color, bool filled=true);
+	void line(Vec2 start, Vec2 end, IntColor color);
+	void triangle(Vec2 a, Vec2 b, Vec2 c, IntColor color);
+	void text(const char* text, RenderFont font, Vec2 loc, float deg, IntColor color, bool centered=true, float lineOffset=0.5);
+	Vec2* points(int count, float radius, IntColor color);
+	
+	int itemCount();
+	int reserve(int count);
+	void recordInto(RenderSnapshot* target, int first);
+	
+	void compare(const RenderSnapshot* previous);
+	int changes();
+	int moves();
+	void setTickMicros(long long micros);
+	long long tickMicros();
+	
+	void sort();
+	void draw(Renderer* renderer);
+};
@@ -0,0 +1,104 @@
+#include "Renderer.h"
+#include <string.h>
+#include <math.h>
+
+/**
+ * Creates a renderer for a target of the specified size, in pixels, whose
+ * state is unknown until the first primitive.
+ */
+Renderer::Renderer(int width, int height)
+{
+	_width = width;
+	_height = height;
+	_filled = true;
+	_colorKnown = false;
+	_filledKnown = false;
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+/**
+ * Starts a frame, resetting the counts. The backend's state is forgotten,
+ * since anything may have changed it since the last frame.
+ */
+void Renderer::begin()
+{
+	_colorKnown = false;
+	_filledKnown = false;
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+/**
+ * Sets the color of the following primitives.
+ */
+void Renderer::setColor(IntColor color)
+{
+	if(_colorKnown && (int32)color == (int32)_color)
+		return;
+	_colorKnown = true;
+	_color = color;
+	applyColor(color);
+	_stats.stateChanges++;
+}
+
+/**
+ * Sets whether the following circles are filled or only outlined.
+ */
+void Renderer::setFilled(bool filled)
+{
+	if(_filledKnown && filled == _filled)
+		return;
+	_filledKnown = true;
+	_filled = filled;
+	applyFilled(filled);
+	_stats.stateChanges++;
+}
+
+/**
+ * Draws a batch of filled circles of the same size. The fill mode must be filled.
+ * Backends that can draw the whole batch at once override this; by default
+ * each circle is drawn on its own.
+ */
+void Renderer::points(const Vec2* locs, int count, float radius)
+{
+	int i;
+	for(i = 0; i < count; i++)
+		circle(locs[i], radius);
+}
+
+/**
+ * Returns whether a filled circle covers every pixel of the target completely,
+ * in which case filling the whole target draws the same thing far more cheaply.
+ */
+bool Renderer::covers(Vec2 loc, float radius)
+{
+	float inside = radius - 0.5f;
+	if(inside <= 0)
+		return false;
+	float dx = max(fabs(loc.x), fabs(_width - loc.x));
+	float dy = max(fabs(loc.y), fabs(_height - loc.y));
+	return dx*dx + dy*dy <= inside*inside;
+}
+
+/**
+ * Returns how much of a pixel a circle covers, from 0 to 1, given the distance
+ * from the circle's center to the pixel's center. Filled circles fade out over the
+ * pixel straddling their edge; outlines are one pixel wide, centered on the radius.
+ * Every backend anti-aliases circles with this so they all draw the same edges.
+ */
+float Renderer::circleCoverage(float distance, float radius, bool filled)
+{
+	float coverage;
+	if(filled)
+		coverage = radius + 0.5f - distance;
+	else
+		coverage = 1 - fabs(distance - radius);
+	return min(max(coverage, 0.0f), 1.0f);
+}
+
+/**
+ * Returns the counts for the current or, after end(), the latest frame.
+ */
+RenderStats* Renderer::stats()
+{
+	return &_stats;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Vec2.h"
+#include "IntColor.h"
+
+struct RenderText;
+
+/**
+ * Counts of the work a Renderer did for one frame.
+ */
+struct RenderStats
+{
+	int primitives; // Circles, lines, triangles, texts, screen fills, and point batches drawn.
+	int stateChanges; // Times the color or fill mode had to change between primitives.
+};
+
+/**
+ * Draws the shapes of a RenderSnapshot somewhere: to the screen through
+ * Open Frameworks, or into memory for benchmarks and image comparisons.
+ * Primitives are drawn in the current color and, for circles, fill mode.
+ * Setting either to what it already is costs nothing and isn't counted,
+ * so the counts show how much state a frame really changes.
+ * Circles are anti-aliased by their distance from each pixel, so their cost
+ * doesn't depend on how finely they're tessellated.
+ */
+class Renderer
+{
+private:
+	
+	IntColor _color;
+	bool _filled;
+	bool _colorKnown; // Whether _color is what the backend last applied.
+	bool _filledKnown; // Whether _filled is what the backend last applied.
+
+protected:
+	
+	int _width;
+	int _height;
+	RenderStats _stats;
+	
+	virtual void applyColor(IntColor color) = 0;
+	virtual void applyFilled(bool filled) = 0;
+
+public:
+	
+	Renderer(int width, int height);
+	virtual ~Renderer(){}
+	
+	virtual void begin();
+	virtual void end(){}
+	
+	void setColor(IntColor color);
+	void setFilled(bool filled);
+	
+	virtual void circle(Vec2 loc, float radius) = 0;
+	virtual void line(Vec2 start, Vec2 end) = 0;
+	virtual void triangle(Vec2 a, Vec2 b, Vec2 c) = 0;
+	virtual void text(const RenderText& text) = 0;
+	virtual void fill() = 0;
+	virtual void points(const Vec2* locs, int count, float radius);
+	
+	bool covers(Vec2 loc, float radius);
+	static float circleCoverage(float distance, float radius, bool filled);
+	
+	RenderStats* stats();
+};
@@ -0,0 +1,170 @@
+#include "RewindBuffer.h"
+#include "Snapshot.h"
+
+// The longest run of either kind that fits in a run header.
+#define MAX_RUN 0xffff
+
+/**
+ * Appends a value to a byte vector.
+ */
+template<class T> static void append(vector<unsigned char>* bytes, T value)
+{
+	int pos = bytes->size();
+	bytes->resize(pos + sizeof(T));
+	memcpy(&(*bytes)[pos], &value, sizeof(T));
+}
+
+/**
+ * Reads a value from a byte vector and advances the position past it.
+ */
+template<class T> static T extract(const vector<unsigned char>& bytes, int* pos)
+{
+	T value;
+	memcpy(&value, &bytes[*pos], sizeof(T));
+	*pos += sizeof(T);
+	return value;
+}
+
+/**
+ * Creates a new, empty RewindBuffer.
+ * @param capacity The number of snapshots to keep. Older ones are dropped.
+ */
+RewindBuffer::RewindBuffer(int capacity)
+{
+	_capacity = capacity;
+}
+
+/**
+ * Adds a snapshot as the newest one, dropping the oldest if the buffer is full.
+ */
+void RewindBuffer::push(Snapshot* snapshot)
+{
+	vector<unsigned char>* bytes = snapshot->bytes();
+	if(!_newest.empty())
+	{
+		_deltas.push_back(vector<unsigned char>());
+		encodeDelta(*bytes, _newest, &_deltas.back());
+		if((int)_deltas.size() >= _capacity)
+			_deltas.pop_front();
+	}
+	_newest = *bytes;
+}
+
+/**
+ * Goes back the specified number of snapshots, discarding the newer ones.
+ * @param count The number of snapshots to go back. 0 is the newest.
+ * @param snapshot Receives the snapshot that is now the newest.
+ * @return false, changing nothing, if the buffer doesn't go back that far.
+ */
+bool RewindBuffer::rewind(int count, Snapshot* snapshot)
+{
+	if(_newest.empty() || count > (int)_deltas.size())
+		return false;
+	
+	int i;
+	for(i = 0; i < count; i++)
+	{
+		applyDelta(_deltas.back(), &_newest);
+		_deltas.pop_back();
+	}
+	snapshot->clear();
+	*snapshot->bytes() = _newest;
+	return true;
+}
+
+/**
+ * Discards every snapshot.
+ */
+void RewindBuffer::clear()
+{
+	_newest.clear();
+	_deltas.clear();
+}
+
+/**
+ * Returns the number of snapshots in the buffer.
+ */
+int RewindBuffer::count()
+{
+	if(_newest.empty())
+		return 0;
+	return _deltas.size() + 1;
+}
+
+/**
+ * Returns the number of bytes used to store the snapshots.
+ */
+int RewindBuffer::memoryUsed()
+{
+	int total = _newest.size();
+	deque<vector<unsigned char> >::iterator iter;
+	for(iter = _deltas.begin(); iter != _deltas.end(); ++iter)
+		total += iter->size();
+	return total;
+}
+
+/**
+ * Encodes the difference that turns one snapshot into another.
+ * The delta is the size of the target, the length of the XOR, and then
+ * alternating runs: a count of zero bytes, a count of literal bytes, and the literals.
+ */
+void RewindBuffer::encodeDelta(const vector<unsigned char>& from, const vector<unsigned char>& to, vector<unsigned char>* delta)
+{
+	int length = max(from.size(), to.size());
+	append<int>(delta, to.size());
+	append<int>(delta, length);
+	
+	int pos = 0;
+	while(pos < length)
+	{
+		int zeros = 0;
+		while(pos < length && zeros < MAX_RUN)
+		{
+			unsigned char a = pos < (int)from.size() ? from[pos] : 0;
+			unsigned char b = pos < (int)to.size() ? to[pos] : 0;
+			if(a != b)
+				break;
+			zeros++;
+			pos++;
+		}
+		
+		int headerPos = delta->size();
+		append<unsigned short>(delta, zeros);
+		append<unsigned short>(delta, 0);
+		int literals = 0;
+		while(pos < length && literals < MAX_RUN)
+		{
+			unsigned char a = pos < (int)from.size() ? from[pos] : 0;
+			unsigned char b = pos < (int)to.size() ? to[pos] : 0;
+			if(a == b)
+				break;
+			delta->push_back(a ^ b);
+			literals++;
+			pos++;
+		}
+		unsigned short literalCount = literals;
+		memcpy(&(*delta)[headerPos + sizeof(unsigned short)], &literalCount, sizeof(literalCount));
+	}
+}
+
+/**
+ * Applies a delta made by encodeDelta to the snapshot it was made from.
+ */
+void RewindBuffer::applyDelta(const vector<unsigned char>& delta, vector<unsigned char>* bytes)
+{
+	int readPos = 0;
+	int size = extract<int>(delta, &readPos);
+	int length = extract<int>(delta, &readPos);
+	bytes->resize(length, 0);
+	
+	int pos = 0;
+	while(readPos < (int)delta.size())
+	{
+		pos += extract<unsigned short>(delta, &readPos);
+		int literals = extract<unsigned short>(delta, &readPos);
+		int i;
+		for(i = 0; i < literals; i++)
+			(*bytes)[pos++] ^= delta[readPos++];
+	}
+	bytes->resize(size);
+}
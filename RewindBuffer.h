@@ -0,0 +1,36 @@
+#pragma once
+
+#include <deque>
+
+class Snapshot;
+
+/**
+ * Keeps the most recent game snapshots for rewinding, at a fraction of their full size.
+ * Only the newest snapshot is stored whole. Each older one is stored as the difference
+ * from the one after it: the two are XORed together, which leaves mostly zeros where
+ * little has changed, and the zeros are run-length encoded.
+ * Pushing and dropping the oldest snapshot are both cheap; rewinding n snapshots
+ * applies n differences to the newest.
+ */
+class RewindBuffer
+{
+private:
+	
+	int _capacity;
+	vector<unsigned char> _newest;
+	deque<vector<unsigned char> > _deltas; // Oldest first. Each one turns a snapshot into the one before it.
+	
+	static void encodeDelta(const vector<unsigned char>& from, const vector<unsigned char>& to, vector<unsigned char>* delta);
+	static void applyDelta(const vector<unsigned char>& delta, vector<unsigned char>* bytes);
+
+public:
+	
+	RewindBuffer(int capacity);
+	
+	void push(Snapshot* snapshot);
+	bool rewind(int count, Snapshot* snapshot);
+	void clear();
+	
+	int count();
+	int memoryUsed();
+};
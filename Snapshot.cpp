@@ -0,0 +1,43 @@
+#include "Snapshot.h"
+
+/**
+ * Creates a new, empty snapshot.
+ */
+Snapshot::Snapshot()
+{
+	_readPos = 0;
+}
+
+/**
+ * Empties the snapshot so that it can be written again.
+ * The memory is kept for reuse.
+ */
+void Snapshot::clear()
+{
+	_bytes.clear();
+	_readPos = 0;
+}
+
+/**
+ * Starts reading from the beginning of the snapshot.
+ */
+void Snapshot::beginRead()
+{
+	_readPos = 0;
+}
+
+/**
+ * Returns the size of the snapshot in bytes.
+ */
+int Snapshot::size()
+{
+	return _bytes.size();
+}
+
+/**
+ * Returns the raw bytes of the snapshot.
+ */
+vector<unsigned char>* Snapshot::bytes()
+{
+	return &_bytes;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string.h>
+
+/**
+ * A compact binary image of simulation state.
+ * Values are appended with write() and then read back in the same order with read().
+ * Only plain data may be written. Pointers to static rules are written as-is,
+ * since a snapshot is only ever restored into the level that captured it.
+ */
+class Snapshot
+{
+private:
+	
+	vector<unsigned char> _bytes;
+	int _readPos;
+
+public:
+	
+	Snapshot();
+	
+	void clear();
+	void beginRead();
+	
+	/**
+	 * Appends the bytes of the specified value.
+	 */
+	template<class T> void write(const T& value)
+	{
+		int pos = _bytes.size();
+		_bytes.resize(pos + sizeof(T));
+		memcpy(&_bytes[pos], &value, sizeof(T));
+	}
+	
+	/**
+	 * Reads the next value. Values must be read in the order they were written.
+	 */
+	template<class T> T read()
+	{
+		T value;
+		memcpy(&value, &_bytes[_readPos], sizeof(T));
+		_readPos += sizeof(T);
+		return value;
+	}
+	
+	int size();
+	vector<unsigned char>* bytes();
+};
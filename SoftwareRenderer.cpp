@@ -0,0 +1,317 @@
+#include "SoftwareRenderer.h"
+#include "RenderSnapshot.h"
+#include <math.h>
+#include <stdio.h>
+
+/**
+ * Creates a renderer with an image of the specified size, in pixels.
+ */
+SoftwareRenderer::SoftwareRenderer(int width, int height)
+	: Renderer(width, height)
+{
+	_pixels.resize(width * height);
+	_color[0] = _color[1] = _color[2] = _color[3] = 0;
+	_fillCircles = true;
+	_pixelsBlended = 0;
+}
+
+/**
+ * Starts a frame by clearing the image to opaque black, as the game's states do.
+ */
+void SoftwareRenderer::begin()
+{
+	Renderer::begin();
+	std::fill(_pixels.begin(), _pixels.end(), 0x000000ff);
+	_pixelsBlended = 0;
+}
+
+/**
+ * Sets the current color.
+ */
+void SoftwareRenderer::applyColor(IntColor color)
+{
+	_color[0] = color.r();
+	_color[1] = color.g();
+	_color[2] = color.b();
+	_color[3] = color.a();
+}
+
+/**
+ * Sets the current fill mode.
+ */
+void SoftwareRenderer::applyFilled(bool filled)
+{
+	_fillCircles = filled;
+}
+
+/**
+ * Blends the current color, with the specified alpha in place of its own, over
+ * the pixels of a row from x0 up to but not including x1.
+ * Every channel, alpha included, becomes src * srcAlpha + dst * (1 - srcAlpha).
+ * Pixels outside the image are skipped.
+ */
+void SoftwareRenderer::blendSpan(int y, int x0, int x1, unsigned int alpha)
+{
+	if(y < 0 || y >= _height)
+		return;
+	x0 = max(x0, 0);
+	x1 = min(x1, _width);
+	if(x0 >= x1 || alpha == 0)
+		return;
+	
+	unsigned int inverse = 255 - alpha;
+	unsigned int r = _color[0] * alpha;
+	unsigned int g = _color[1] * alpha;
+	unsigned int b = _color[2] * alpha;
+	unsigned int a = alpha * alpha;
+	unsigned int* pixel = &_pixels[y * _width + x0];
+	unsigned int* end = pixel + (x1 - x0);
+	for(; pixel != end; ++pixel)
+	{
+		unsigned int dst = *pixel;
+		unsigned int dr = (r + (dst >> 24) * inverse) / 255;
+		unsigned int dg = (g + ((dst >> 16) & 0xff) * inverse) / 255;
+		unsigned int db = (b + ((dst >> 8) & 0xff) * inverse) / 255;
+		unsigned int da = (a + (dst & 0xff) * inverse) / 255;
+		*pixel = (dr << 24) | (dg << 16) | (db << 8) | da;
+	}
+	_pixelsBlended += x1 - x0;
+}
+
+/**
+ * Blends the current color, with the specified alpha, over a single pixel.
+ */
+void SoftwareRenderer::blendPixel(int x, int y, unsigned int alpha)
+{
+	blendSpan(y, x, x + 1, alpha);
+}
+
+/**
+ * Blends the pixels of a row from x0 up to but not including x1 by how much
+ * of each the current circle covers.
+ */
+void SoftwareRenderer::blendCircleEdge(int y, int x0, int x1, Vec2 loc, float radius)
+{
+	float dy = y + 0.5f - loc.y;
+	int x;
+	for(x = max(x0, 0); x < min(x1, _width); x++)
+	{
+		float dx = x + 0.5f - loc.x;
+		float coverage = circleCoverage(sqrt(dx*dx + dy*dy), radius, _fillCircles);
+		blendPixel(x, y, (unsigned int)(_color[3] * coverage + 0.5f));
+	}
+}
+
+/**
+ * Finds the pixels of a row whose centers lie within a circle.
+ * @param radius The radius of the circle.
+ * @param dy The distance from the circle's center to the row's pixel centers.
+ * @param cx The x coordinate of the circle's center.
+ * @param x0 Set to the first pixel inside.
+ * @param x1 Set to just past the last pixel inside, or to x0 if none are.
+ */
+void SoftwareRenderer::circleSpan(float radius, float dy, float cx, int* x0, int* x1)
+{
+	float halfSquared = radius*radius - dy*dy;
+	if(halfSquared < 0)
+	{
+		*x0 = *x1 = 0;
+		return;
+	}
+	float half = sqrt(halfSquared);
+	*x0 = (int)ceil(cx - half - 0.5f);
+	*x1 = (int)floor(cx + half - 0.5f) + 1;
+	if(*x1 < *x0)
+		*x1 = *x0;
+}
+
+/**
+ * Draws a circle, filled or as a one-pixel outline depending on the fill mode.
+ * Only the pixels near the edge need their coverage worked out; those wholly
+ * inside a filled circle are blended a row at a time.
+ */
+void SoftwareRenderer::circle(Vec2 loc, float radius)
+{
+	_stats.primitives++;
+	float outer = _fillCircles ? radius + 0.5f : radius + 1;
+	float inner = _fillCircles ? radius - 0.5f : radius - 1;
+	int top = max((int)floor(loc.y - outer), 0);
+	int bottom = min((int)ceil(loc.y + outer), _height - 1);
+	int y;
+	for(y = top; y <= bottom; y++)
+	{
+		float dy = y + 0.5f - loc.y;
+		int x0;
+		int x1;
+		circleSpan(outer, dy, loc.x, &x0, &x1);
+		int innerX0 = x1;
+		int innerX1 = x1;
+		if(inner > 0)
+			circleSpan(inner, dy, loc.x, &innerX0, &innerX1);
+		if(innerX0 >= innerX1)
+		{
+			blendCircleEdge(y, x0, x1, loc, radius);
+			continue;
+		}
+		
+		// The pixels between the edges are either fully covered or not at all.
+		blendCircleEdge(y, x0, innerX0, loc, radius);
+		if(_fillCircles)
+			blendSpan(y, innerX0, innerX1, _color[3]);
+		blendCircleEdge(y, innerX1, x1, loc, radius);
+	}
+}
+
+/**
+ * Draws a one-pixel line by stepping along its longer axis.
+ */
+void SoftwareRenderer::line(Vec2 start, Vec2 end)
+{
+	_stats.primitives++;
+	Vec2 diff = end - start;
+	int steps = (int)ceil(max(fabs(diff.x), fabs(diff.y)));
+	if(steps == 0)
+	{
+		blendPixel((int)floor(start.x), (int)floor(start.y), _color[3]);
+		return;
+	}
+	
+	Vec2 step = diff / steps;
+	Vec2 point = start;
+	int i;
+	for(i = 0; i <= steps; i++)
+	{
+		blendPixel((int)floor(point.x), (int)floor(point.y), _color[3]);
+		point += step;
+	}
+}
+
+/**
+ * Draws a filled triangle, covering the pixels whose centers lie within it
+ * whichever way round its corners are given.
+ */
+void SoftwareRenderer::triangle(Vec2 a, Vec2 b, Vec2 c)
+{
+	_stats.primitives++;
+	float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+	if(area == 0)
+		return;
+	float sign = area > 0 ? 1 : -1;
+	
+	int left = max((int)floor(min(a.x, min(b.x, c.x))), 0);
+	int right = min((int)ceil(max(a.x, max(b.x, c.x))), _width - 1);
+	int top = max((int)floor(min(a.y, min(b.y, c.y))), 0);
+	int bottom = min((int)ceil(max(a.y, max(b.y, c.y))), _height - 1);
+	int x;
+	int y;
+	for(y = top; y <= bottom; y++)
+	{
+		float py = y + 0.5f;
+		for(x = left; x <= right; x++)
+		{
+			float px = x + 0.5f;
+			float e0 = ((b.x - a.x) * (py - a.y) - (b.y - a.y) * (px - a.x)) * sign;
+			float e1 = ((c.x - b.x) * (py - b.y) - (c.y - b.y) * (px - b.x)) * sign;
+			float e2 = ((a.x - c.x) * (py - c.y) - (a.y - c.y) * (px - c.x)) * sign;
+			if(e0 >= 0 && e1 >= 0 && e2 >= 0)
+				blendPixel(x, y, _color[3]);
+		}
+	}
+}
+
+/**
+ * Counts a string without drawing it.
+ */
+void SoftwareRenderer::text(const RenderText& text)
+{
+	_stats.primitives++;
+}
+
+/**
+ * Blends the current color over the whole image.
+ */
+void SoftwareRenderer::fill()
+{
+	_stats.primitives++;
+	int y;
+	for(y = 0; y < _height; y++)
+		blendSpan(y, 0, _width, _color[3]);
+}
+
+/**
+ * Returns the width of the image, in pixels.
+ */
+int SoftwareRenderer::width()
+{
+	return _width;
+}
+
+/**
+ * Returns the height of the image, in pixels.
+ */
+int SoftwareRenderer::height()
+{
+	return _height;
+}
+
+/**
+ * Returns the color of the specified pixel.
+ */
+IntColor SoftwareRenderer::pixel(int x, int y)
+{
+	return IntColor((int32)_pixels[y * _width + x]);
+}
+
+/**
+ * Returns the number of pixels blended since the frame began, counting
+ * a pixel once for every shape that covered it.
+ */
+long long SoftwareRenderer::pixelsBlended()
+{
+	return _pixelsBlended;
+}
+
+/**
+ * Returns a 64-bit FNV-1a hash of the image, for comparing frames with known-good ones.
+ */
+unsigned long long SoftwareRenderer::checksum()
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	vector<unsigned int>::iterator iter;
+	for(iter = _pixels.begin(); iter != _pixels.end(); ++iter)
+	{
+		hash ^= *iter;
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+/**
+ * Writes the image to the specified file as a binary PPM, without its alpha channel.
+ * Returns whether the file was written.
+ */
+bool SoftwareRenderer::save(const char* path)
+{
+	FILE* file = fopen(path, "wb");
+	if(file == NULL)
+		return false;
+	
+	fprintf(file, "P6\n%d %d\n255\n", _width, _height);
+	vector<unsigned char> row(_width * 3);
+	int x;
+	int y;
+	for(y = 0; y < _height; y++)
+	{
+		for(x = 0; x < _width; x++)
+		{
+			unsigned int pixel = _pixels[y * _width + x];
+			row[x*3] = pixel >> 24;
+			row[x*3 + 1] = (pixel >> 16) & 0xff;
+			row[x*3 + 2] = (pixel >> 8) & 0xff;
+		}
+		fwrite(&row[0], 1, row.size(), file);
+	}
+	bool written = ferror(file) == 0;
+	fclose(file);
+	return written;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Renderer.h"
+
+/**
+ * Draws into an RGBA image in memory, one screen in size, with no GPU at all.
+ * Used to measure draw costs and compare frames against known-good images
+ * on machines without a display.
+ * Circles are anti-aliased by Renderer::circleCoverage(), as on the screen. Other
+ * shapes cover the pixels whose centers they contain, without anti-aliasing.
+ * Everything is blended as Open Frameworks blends with alpha blending enabled.
+ * Lines are one pixel wide, as are circle outlines. Texts are counted but not drawn,
+ * since the fonts are only available to Open Frameworks.
+ */
+class SoftwareRenderer : public Renderer
+{
+private:
+	
+	vector<unsigned int> _pixels; // Row by row, each packed like an IntColor.
+	unsigned int _color[4]; // The current color's components, r, g, b, and a.
+	bool _fillCircles; // The current fill mode.
+	long long _pixelsBlended;
+	
+	void blendSpan(int y, int x0, int x1, unsigned int alpha);
+	void blendPixel(int x, int y, unsigned int alpha);
+	void blendCircleEdge(int y, int x0, int x1, Vec2 loc, float radius);
+	static void circleSpan(float radius, float dy, float cx, int* x0, int* x1);
+
+protected:
+	
+	void applyColor(IntColor color);
+	void applyFilled(bool filled);
+
+public:
+	
+	SoftwareRenderer(int width, int height);
+	
+	void begin();
+	
+	void circle(Vec2 loc, float radius);
+	void line(Vec2 start, Vec2 end);
+	void triangle(Vec2 a, Vec2 b, Vec2 c);
+	void text(const RenderText& text);
+	void fill();
+	
+	int width();
+	int height();
+	IntColor pixel(int x, int y);
+	long long pixelsBlended();
+	unsigned long long checksum();
+	bool save(const char* path);
+};
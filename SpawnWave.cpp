@@ -0,0 +1,19 @@
+#include "SpawnWave.h"
+#include "rules.h"
+
+/**
+ * Returns a wave that spawns every enemy on the full ring at the start of the level.
+ * This is the schedule used by levels that don't define their own.
+ */
+SpawnWave SpawnWave::allAtOnce(int count, EnemyRules* enemyRules)
+{
+	SpawnWave wave;
+	wave.frame = 0;
+	wave.count = count;
+	wave.minDist = ENEMY_MIN_DIST;
+	wave.maxDist = ENEMY_MAX_DIST;
+	wave.minDeg = 0;
+	wave.maxDeg = 360;
+	wave.enemyRules = enemyRules;
+	return wave;
+}
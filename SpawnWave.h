@@ -0,0 +1,20 @@
+#pragma once
+
+struct EnemyRules;
+
+/**
+ * Describes a group of enemies that enter the game together at a particular frame.
+ * Enemies are placed at random on a ring (or an arc of a ring) around the center of the screen.
+ */
+struct SpawnWave
+{
+	int frame; // The frame at which the enemies enter the game. Frames in the past spawn immediately.
+	int count; // The number of enemies to spawn.
+	int minDist; // The minimum distance from the center of the screen.
+	int maxDist; // The maximum distance from the center of the screen.
+	int minDeg; // The start of the arc (in degrees) on which the enemies are placed.
+	int maxDeg; // The end of the arc (in degrees) on which the enemies are placed.
+	EnemyRules* enemyRules; // The rules for the spawned enemies.
+	
+	static SpawnWave allAtOnce(int count, EnemyRules* enemyRules);
+};
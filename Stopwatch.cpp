@@ -0,0 +1,36 @@
+#include "Stopwatch.h"
+#include <sys/time.h>
+
+/**
+ * Creates a new Stopwatch that starts timing immediately.
+ */
+Stopwatch::Stopwatch()
+{
+	start();
+}
+
+/**
+ * Restarts this Stopwatch from zero.
+ */
+void Stopwatch::start()
+{
+	_startMicros = nowMicros();
+}
+
+/**
+ * Returns the number of microseconds since this Stopwatch was last started.
+ */
+long long Stopwatch::elapsedMicros()
+{
+	return nowMicros() - _startMicros;
+}
+
+/**
+ * Returns the current wall-clock time in microseconds.
+ */
+long long Stopwatch::nowMicros()
+{
+	timeval tv;
+	gettimeofday(&tv, NULL);
+	return (long long)tv.tv_sec * 1000000 + tv.tv_usec;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+/**
+ * A simple wall-clock timer with microsecond resolution.
+ * Used to measure the cost of the game's various subsystems.
+ */
+class Stopwatch
+{
+private:
+	
+	long long _startMicros;
+	
+public:
+	
+	Stopwatch();
+	
+	void start();
+	long long elapsedMicros();
+	
+	static long long nowMicros();
+};
@@ -0,0 +1,186 @@
+#include "StressBenchmark.h"
+#include "App.h"
+#include "Game.h"
+#include "StressLevel.h"
+#include "FrameStats.h"
+#include "FastMath.h"
+#include "RenderSnapshot.h"
+#include "rules.h"
+
+// The enemy populations to try, in increasing order.
+static const int populations[] = {1000, 2000, 5000, 10000, 20000, 35000, 50000};
+static const int populationCount = sizeof(populations) / sizeof(populations[0]);
+
+static const char* subsystemNames[STRESS_SUBSYSTEM_COUNT] = {"update", "collision", "draw"};
+
+/**
+ * Creates a new StressBenchmark.
+ * @param app The main application object, used by the benchmarked games for fonts.
+ */
+StressBenchmark::StressBenchmark(App* app)
+{
+	_app = app;
+	_populationIndex = 0;
+	_frame = 0;
+	_totalAwake = 0;
+	_done = false;
+	
+	int i;
+	for(i = 0; i < STRESS_SUBSYSTEM_COUNT; i++)
+	{
+		_totalMicros[i] = 0;
+		_sustained[i] = 0;
+	}
+}
+
+/**
+ * Called when this benchmark becomes the active application state.
+ */
+void StressBenchmark::activate()
+{
+	startPopulation();
+}
+
+/**
+ * Creates a fresh game with the current population and clears the timing totals.
+ */
+void StressBenchmark::startPopulation()
+{
+	StressLevelRules rules;
+	rules.enemyCount = populations[_populationIndex];
+	rules.emitterCount = STRESS_EMITTER_COUNT;
+	rules.fireInterval = STRESS_FIRE_INTERVAL;
+	rules.emitterRotVel = STRESS_EMITTER_ROT_VEL;
+	rules.enemyRadius = STRESS_ENEMY_RAD;
+	rules.enemySpeed = STRESS_ENEMY_SPEED;
+	rules.bulletRadius = STRESS_BULLET_RAD;
+	rules.gravityFactor = STRESS_GRAVITY_FACTOR;
+	
+	_game = shared_ptr<Game>(new Game(_app, shared_ptr<LevelBase>(new StressLevel(rules))));
+	if(PARALLEL_UPDATE)
+		_game->setUpdatePool(_app->updatePool());
+	if(PARALLEL_RENDER)
+		_game->setRenderPool(_app->updatePool());
+	_frame = 0;
+	_totalAwake = 0;
+	
+	int i;
+	for(i = 0; i < STRESS_SUBSYSTEM_COUNT; i++)
+		_totalMicros[i] = 0;
+}
+
+/**
+ * Averages the timings of the current population, records which subsystems
+ * kept up with the target tick rate, and moves on to the next population.
+ * The benchmark ends early once every subsystem has fallen behind.
+ */
+void StressBenchmark::finishPopulation()
+{
+	int population = populations[_populationIndex];
+	long long budget = 1000000 / STRESS_TARGET_TICK_RATE;
+	bool anySustained = false;
+	
+	printf("stress: %d enemies, %lld awake on average, %s math, %s update", population, _totalAwake / STRESS_SAMPLE_FRAMES,
+		   FastMath::isEnabled() ? "fast" : "accurate", _game->updatePool() != NULL ? "parallel" : "serial");
+	int i;
+	for(i = 0; i < STRESS_SUBSYSTEM_COUNT; i++)
+	{
+		long long avg = _totalMicros[i] / STRESS_SAMPLE_FRAMES;
+		printf(", %s %lldus", subsystemNames[i], avg);
+		if(avg <= budget)
+		{
+			_sustained[i] = population;
+			anySustained = true;
+		}
+	}
+	printf("\n");
+	
+	_populationIndex++;
+	if(!anySustained || _populationIndex >= populationCount)
+	{
+		_done = true;
+		_game.reset();
+		
+		printf("stress: largest population sustaining %d ticks/sec:", STRESS_TARGET_TICK_RATE);
+		for(i = 0; i < STRESS_SUBSYSTEM_COUNT; i++)
+			printf(" %s %d", subsystemNames[i], _sustained[i]);
+		printf("\n");
+	}
+	else
+	{
+		startPopulation();
+	}
+}
+
+/**
+ * Called by the application to advance the benchmarked game by one tick.
+ */
+void StressBenchmark::update()
+{
+	if(_done)
+		return;
+	
+	if(_frame == STRESS_WARMUP_FRAMES + STRESS_SAMPLE_FRAMES)
+	{
+		finishPopulation();
+		if(_done)
+			return;
+	}
+	
+	_game->update();
+	_frame++;
+	
+	if(_frame > STRESS_WARMUP_FRAMES)
+	{
+		FrameStats* stats = _game->stats();
+		_totalMicros[STRESS_UPDATE] += stats->updateMicros - stats->collisionMicros;
+		_totalMicros[STRESS_COLLISION] += stats->collisionMicros;
+		_totalAwake += _game->awakeEnemyCount();
+	}
+}
+
+/**
+ * Called by the application to record the benchmarked game and the progress text.
+ * The draw subsystem is measured by how long the game takes to record itself.
+ */
+void StressBenchmark::render(RenderSnapshot* snapshot)
+{
+	if(_game)
+	{
+		_game->render(snapshot);
+		if(_frame > STRESS_WARMUP_FRAMES)
+			_totalMicros[STRESS_DRAW] += _game->stats()->drawMicros;
+	}
+	
+	const int STR_LEN = 128;
+	char str[STR_LEN];
+	if(_done)
+	{
+		snprintf(str, STR_LEN, "update %d\ncollision %d\ndraw %d",
+				 _sustained[STRESS_UPDATE], _sustained[STRESS_COLLISION], _sustained[STRESS_DRAW]);
+	}
+	else
+	{
+		snprintf(str, STR_LEN, "STRESS %d", populations[_populationIndex]);
+	}
+	
+	snapshot->setLayer(RENDER_LAYER_OVERLAY);
+	snapshot->text(str, RENDER_FONT_SMALL, Vec2(10, 20), 0, IntColor(255, 255, 255, 255), false);
+}
+
+/**
+ * Returns the largest population at which the specified subsystem kept up
+ * with the target tick rate, or 0 if it never did.
+ */
+int StressBenchmark::sustainedPopulation(StressSubsystem subsystem)
+{
+	return _sustained[subsystem];
+}
+
+/**
+ * Returns whether every population has been measured.
+ */
+bool StressBenchmark::isDone()
+{
+	return _done;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "AppState.h"
+
+class App;
+class Game;
+
+/**
+ * Indexes of the subsystems measured by the StressBenchmark.
+ */
+enum StressSubsystem
+{
+	STRESS_UPDATE,
+	STRESS_COLLISION,
+	STRESS_DRAW,
+	STRESS_SUBSYSTEM_COUNT
+};
+
+/**
+ * An application state that runs StressLevel games of increasing enemy population
+ * and reports, for each subsystem, the largest population whose average cost
+ * still fits within a single tick at the target tick rate, along with how many
+ * of the enemies were awake, since sleeping enemies cost next to nothing.
+ */
+class StressBenchmark : public AppState
+{
+private:
+	
+	App* _app;
+	shared_ptr<Game> _game;
+	int _populationIndex;
+	int _frame;
+	long long _totalMicros[STRESS_SUBSYSTEM_COUNT];
+	long long _totalAwake; // The sum of the awake enemy counts over the measured frames.
+	int _sustained[STRESS_SUBSYSTEM_COUNT];
+	bool _done;
+	
+	void startPopulation();
+	void finishPopulation();
+	
+public:
+	
+	StressBenchmark(App* app);
+	
+	void activate();
+	void update();
+	void render(RenderSnapshot* snapshot);
+	
+	int sustainedPopulation(StressSubsystem subsystem);
+	bool isDone();
+};
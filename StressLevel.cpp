@@ -0,0 +1,70 @@
+#include "StressLevel.h"
+#include "Game.h"
+#include "rules.h"
+#include "SpawnWave.h"
+
+/**
+ * Creates a new StressLevel, generating the rules for each emitter.
+ * Emitters are spaced evenly on a ring around the center of the screen
+ * and each starts facing outwards.
+ */
+StressLevel::StressLevel(const StressLevelRules& rules)
+{
+	_rules = rules;
+	
+	_bulletRules.radius = rules.bulletRadius;
+	_bulletRules.gravityFactor = rules.gravityFactor;
+	_enemyRules.radius = rules.enemyRadius;
+	_enemyRules.speed = rules.enemySpeed;
+	
+	_playerRules.resize(rules.emitterCount);
+	_playerLocs.resize(rules.emitterCount);
+	int i;
+	for(i = 0; i < rules.emitterCount; i++)
+	{
+		float deg = 360.0f * i / rules.emitterCount;
+		float rad = ofDegToRad(deg);
+		
+		PlayerRules& pr = _playerRules[i];
+		_playerLocs[i] = SCREEN_CENTER + Vec2(STRESS_EMITTER_RING_RAD * cos(rad), STRESS_EMITTER_RING_RAD * sin(rad));
+		pr.locs = &_playerLocs[i];
+		pr.locCount = 1;
+		pr.speed = 0;
+		pr.initRot = deg + 90;
+		pr.rotVel = rules.emitterRotVel;
+		pr.fireInterval = rules.fireInterval;
+		pr.fireVel = Vec2(0, -12);
+		pr.bulletRules = &_bulletRules;
+	}
+}
+
+/**
+ * Called by the Game to populate the GameObjects.
+ * Enemies all spawn at the start, on and just around the screen outside the
+ * emitters, so that bullets meet them from the first frames measured and the
+ * measured frames exercise every subsystem with the horde awake.
+ */
+void StressLevel::populateGame(Game* game)
+{
+	// Create emitters.
+	int i;
+	for(i = 0; i < _rules.emitterCount; i++)
+	{
+		Player* player = new Player(game, &_playerRules[i]);
+		game->addGameObject(shared_ptr<Player>(player));
+	}
+	
+	// Schedule enemies.
+	SpawnWave wave = SpawnWave::allAtOnce(_rules.enemyCount, &_enemyRules);
+	wave.minDist = STRESS_SPAWN_MIN_DIST;
+	wave.maxDist = STRESS_SPAWN_MAX_DIST;
+	game->scheduleSpawn(wave);
+}
+
+/**
+ * Returns the rules this level was generated from.
+ */
+StressLevelRules* StressLevel::rules()
+{
+	return &_rules;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "LevelBase.h"
+#include "Player.h"
+#include "Bullet.h"
+#include "Enemy.h"
+
+class Game;
+
+/**
+ * Contains the rules for a generated stress-test level.
+ */
+struct StressLevelRules
+{
+	int enemyCount; // The number of enemies to spawn.
+	int emitterCount; // The number of player ships firing bullets.
+	int fireInterval; // The interval between bullet spawns for each emitter.
+	float emitterRotVel; // The rotational velocity of each emitter.
+	float enemyRadius; // The radius of the enemies.
+	float enemySpeed; // The speed of the enemies.
+	float bulletRadius; // The radius of the bullets.
+	float gravityFactor; // The gravity factor of the bullets.
+};
+
+/**
+ * A level that populates a Game with a configurable horde of enemies
+ * and a ring of emitters, used to find where the engine stops keeping up.
+ * Unlike GenericLevel, it owns the player, bullet, and enemy rules it generates.
+ */
+class StressLevel : public LevelBase
+{
+private:
+	
+	StressLevelRules _rules;
+	vector<PlayerRules> _playerRules;
+	vector<Vec2> _playerLocs;
+	BulletRules _bulletRules;
+	EnemyRules _enemyRules;
+	
+public:
+	
+	StressLevel(const StressLevelRules& rules);
+	
+	virtual void populateGame(Game* game);
+	
+	StressLevelRules* rules();
+};
@@ -0,0 +1,165 @@
+#include "Telemetry.h"
+#include "rules.h"
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+
+#define TELEMETRY_MAGIC 0x54454c4d
+#define TELEMETRY_MASK (TELEMETRY_RECORDS - 1)
+
+/**
+ * Creates a ring that isn't open yet.
+ */
+TelemetryRing::TelemetryRing()
+{
+	_header = NULL;
+	_records = NULL;
+	_size = sizeof(TelemetryHeader) + sizeof(TelemetryRecord) * TELEMETRY_RECORDS;
+}
+
+/**
+ * Unmaps the shared memory, leaving it for any viewers.
+ */
+TelemetryRing::~TelemetryRing()
+{
+	detach();
+}
+
+/**
+ * Maps the shared memory named TELEMETRY_NAME, creating it if it's to be written.
+ * Returns false if it can't be.
+ */
+bool TelemetryRing::map(bool writable)
+{
+	int fd = shm_open(TELEMETRY_NAME, writable ? O_RDWR | O_CREAT : O_RDONLY, 0600);
+	if(fd < 0)
+		return false;
+	if(writable && ftruncate(fd, _size) != 0)
+	{
+		close(fd);
+		return false;
+	}
+	
+	void* memory = mmap(NULL, _size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(memory == MAP_FAILED)
+		return false;
+	_header = (TelemetryHeader*)memory;
+	_records = (TelemetryRecord*)(_header + 1);
+	return true;
+}
+
+/**
+ * Opens the ring for the game to write, emptying it.
+ * Returns false if the shared memory can't be created, in which case writes do nothing.
+ */
+bool TelemetryRing::create()
+{
+	detach();
+	if(!map(true))
+		return false;
+	
+	// Viewers ignore the ring until the magic number is back.
+	__sync_lock_test_and_set(&_header->magic, 0);
+	_header->capacity = TELEMETRY_RECORDS;
+	_header->recordSize = sizeof(TelemetryRecord);
+	__sync_lock_test_and_set(&_header->written, 0);
+	__sync_lock_test_and_set(&_header->magic, TELEMETRY_MAGIC);
+	return true;
+}
+
+/**
+ * Opens the ring for a viewer to read.
+ * Returns false if the game hasn't created it or it was made by a different build.
+ */
+bool TelemetryRing::attach()
+{
+	detach();
+	if(!map(false))
+		return false;
+	
+	if(_header->magic != TELEMETRY_MAGIC
+	   || _header->capacity != TELEMETRY_RECORDS || _header->recordSize != (int)sizeof(TelemetryRecord))
+	{
+		detach();
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Closes the ring, if it's open.
+ */
+void TelemetryRing::detach()
+{
+	if(_header == NULL)
+		return;
+	munmap(_header, _size);
+	_header = NULL;
+	_records = NULL;
+}
+
+/**
+ * Returns whether the ring is open.
+ */
+bool TelemetryRing::isOpen()
+{
+	return _header != NULL;
+}
+
+/**
+ * Adds a record, overwriting the oldest once the ring is full.
+ * Called by the one writer only.
+ */
+void TelemetryRing::write(const TelemetryRecord& record)
+{
+	if(_header == NULL)
+		return;
+	
+	// Fill the slot before publishing it.
+	unsigned int written = _header->written;
+	_records[written & TELEMETRY_MASK] = record;
+	__sync_fetch_and_add(&_header->written, 1);
+}
+
+/**
+ * Copies the records written since the specified one, oldest first.
+ * Records overwritten before they could be copied are skipped.
+ * @param next The number of the first record wanted. Set to just past the last
+ * record copied, or to 0 if the game has started again since.
+ * @param records Where to copy the records.
+ * @param max The most records to copy.
+ * Returns the number of records copied.
+ */
+int TelemetryRing::read(unsigned int* next, TelemetryRecord* records, int max)
+{
+	if(_header == NULL)
+		return 0;
+	
+	// A viewer's memory is read-only, so it reads the count between barriers
+	// rather than with an atomic add.
+	unsigned int written = _header->written;
+	__sync_synchronize();
+	if(written < *next)
+		*next = 0;
+	if(written - *next > TELEMETRY_RECORDS)
+		*next = written - TELEMETRY_RECORDS;
+	int count = min((int)(written - *next), max);
+	int i;
+	for(i = 0; i < count; i++)
+		records[i] = _records[(*next + i) & TELEMETRY_MASK];
+	
+	// The writer may have refilled the oldest slots while they were being copied.
+	// A slot is refilled before the count is bumped, so any record a whole ring's
+	// length or more behind the count now may be torn.
+	__sync_synchronize();
+	unsigned int after = _header->written;
+	int torn = 0;
+	while(torn < count && after - (*next + torn) >= TELEMETRY_RECORDS)
+		torn++;
+	if(torn > 0)
+		memmove(records, records + torn, (count - torn) * sizeof(TelemetryRecord));
+	*next += count;
+	return count - torn;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+/**
+ * One frame's stats, as written to a TelemetryRing.
+ * Every field is 32 bits, so the layout is the same for a 32-bit game and a
+ * 64-bit viewer.
+ */
+struct TelemetryRecord
+{
+	int frame; // The game frame the record describes.
+	int updateMicros; // Time spent in Game::update, including collision.
+	int collisionMicros; // Time spent testing bullets against enemies.
+	int recordMicros; // Time spent in Game::render, recording the frame for drawing.
+	int drawMicros; // Time the main thread took to draw the latest frame it drew.
+	int players;
+	int bullets;
+	int enemies; // Awake and asleep.
+	int gobjects; // Awake GameObjects.
+	int collisionTests; // Number of bullet/enemy pairs tested.
+	int objectsAdded; // GameObjects added to the game during the frame.
+	int qualityLevel; // The QualityScaler level the frame was recorded at.
+};
+
+/**
+ * The start of a TelemetryRing's shared memory, followed by its records.
+ */
+struct TelemetryHeader
+{
+	volatile unsigned int magic; // TELEMETRY_MAGIC once the rest is set up.
+	int capacity; // The number of records the ring holds.
+	int recordSize; // sizeof(TelemetryRecord), to catch a mismatched viewer.
+	volatile unsigned int written; // The number of records ever written.
+};
+
+/**
+ * A fixed-size ring of TelemetryRecords in POSIX shared memory, written by the
+ * game one record a frame and read by any number of viewer processes.
+ * There is one writer, which fills a slot and then bumps the count. A reader
+ * copies the records it's missing and then reads the count again; any slot the
+ * writer could have reached meanwhile is thrown away. So neither side ever
+ * takes a lock or waits, and a slow reader only loses the oldest records.
+ * The memory outlives the game, so a viewer can be started before or after it;
+ * when the game starts again it resets the count and viewers start over.
+ */
+class TelemetryRing
+{
+private:
+	
+	TelemetryHeader* _header;
+	TelemetryRecord* _records;
+	int _size; // The size of the mapped memory, in bytes.
+	
+	bool map(bool writable);
+
+public:
+	
+	TelemetryRing();
+	~TelemetryRing();
+	
+	bool create();
+	bool attach();
+	void detach();
+	bool isOpen();
+	
+	void write(const TelemetryRecord& record);
+	int read(unsigned int* next, TelemetryRecord* records, int max);
+};
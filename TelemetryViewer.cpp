@@ -0,0 +1,80 @@
+#include "TelemetryViewer.h"
+#include "Stopwatch.h"
+#include "rules.h"
+#include <stdio.h>
+#include <unistd.h>
+
+/**
+ * Creates a viewer that isn't watching anything yet.
+ */
+TelemetryViewer::TelemetryViewer()
+	: _records(TELEMETRY_RECORDS)
+{
+	_next = 0;
+}
+
+/**
+ * Watches the game, waiting for it to start if it hasn't.
+ * @param seconds How long to watch for, or 0 to watch until killed.
+ */
+void TelemetryViewer::run(int seconds)
+{
+	long long endMicros = Stopwatch::nowMicros() + seconds * 1000000LL;
+	bool waiting = false;
+	while(seconds == 0 || Stopwatch::nowMicros() < endMicros)
+	{
+		usleep(TELEMETRY_VIEW_MICROS);
+		if(!_ring.isOpen() && !_ring.attach())
+		{
+			if(!waiting)
+				printf("telemetry: waiting for the game to start\n");
+			waiting = true;
+			continue;
+		}
+		waiting = false;
+		
+		int count = _ring.read(&_next, &_records[0], _records.size());
+		print(&_records[0], count);
+	}
+}
+
+/**
+ * Prints one line summing up the specified records: the time taken, on average
+ * and at worst, the work done, and the object counts as of the latest.
+ */
+void TelemetryViewer::print(const TelemetryRecord* records, int count)
+{
+	if(count == 0)
+	{
+		printf("telemetry: no frames\n");
+		return;
+	}
+	
+	long long update = 0;
+	long long record = 0;
+	long long draw = 0;
+	long long tests = 0;
+	long long objectsAdded = 0;
+	int maxUpdate = 0;
+	int maxRecord = 0;
+	int maxDraw = 0;
+	int i;
+	for(i = 0; i < count; i++)
+	{
+		update += records[i].updateMicros;
+		record += records[i].recordMicros;
+		draw += records[i].drawMicros;
+		tests += records[i].collisionTests;
+		objectsAdded += records[i].objectsAdded;
+		maxUpdate = max(maxUpdate, records[i].updateMicros);
+		maxRecord = max(maxRecord, records[i].recordMicros);
+		maxDraw = max(maxDraw, records[i].drawMicros);
+	}
+	
+	const TelemetryRecord& latest = records[count - 1];
+	printf("telemetry: frame %d, %d frames, update %lld/%dus record %lld/%dus draw %lld/%dus (avg/max), "
+		   "%.1f tests %.1f objects added per frame, %d objects %d players %d bullets %d enemies, quality %d\n",
+		   latest.frame, count, update / count, maxUpdate, record / count, maxRecord, draw / count, maxDraw,
+		   (float)tests / count, (float)objectsAdded / count, latest.gobjects, latest.players, latest.bullets, latest.enemies,
+		   latest.qualityLevel);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Telemetry.h"
+
+/**
+ * Watches a running game through its TelemetryRing from another process,
+ * printing a summary of the frames it played every TELEMETRY_VIEW_MICROS.
+ * Only reads the ring, so watching doesn't change how the game runs.
+ */
+class TelemetryViewer
+{
+private:
+	
+	TelemetryRing _ring;
+	unsigned int _next; // The number of the next record to read.
+	vector<TelemetryRecord> _records;
+	
+	void print(const TelemetryRecord* records, int count);
+
+public:
+	
+	TelemetryViewer();
+	
+	void run(int seconds);
+};
@@ -0,0 +1,192 @@
+#include "ThreadPool.h"
+#include "Trace.h"
+#include <unistd.h>
+
+/**
+ * Creates a pool and starts its worker threads.
+ * @param threadCount The number of worker threads, not counting the thread that calls wait().
+ */
+ThreadPool::ThreadPool(int threadCount)
+{
+	_nextWorker = 0;
+	_queued = 0;
+	_unfinished = 0;
+	_stopping = false;
+	pthread_mutex_init(&_lock, NULL);
+	pthread_cond_init(&_jobsQueued, NULL);
+	pthread_cond_init(&_jobsFinished, NULL);
+	
+	// Create every queue before starting any thread, since workers steal from all of them.
+	int i;
+	for(i = 0; i <= threadCount; i++)
+	{
+		Worker* worker = new Worker();
+		worker->pool = this;
+		worker->index = i;
+		pthread_mutex_init(&worker->lock, NULL);
+		_workers.push_back(worker);
+	}
+	for(i = 0; i < threadCount; i++)
+		pthread_create(&_workers[i]->thread, NULL, workerMain, _workers[i]);
+}
+
+/**
+ * Finishes any submitted jobs, then stops the worker threads.
+ */
+ThreadPool::~ThreadPool()
+{
+	wait();
+	
+	pthread_mutex_lock(&_lock);
+	_stopping = true;
+	pthread_cond_broadcast(&_jobsQueued);
+	pthread_mutex_unlock(&_lock);
+	
+	int i;
+	for(i = 0; i < threadCount(); i++)
+		pthread_join(_workers[i]->thread, NULL);
+	for(i = 0; i < (int)_workers.size(); i++)
+	{
+		pthread_mutex_destroy(&_workers[i]->lock);
+		delete _workers[i];
+	}
+	
+	pthread_cond_destroy(&_jobsFinished);
+	pthread_cond_destroy(&_jobsQueued);
+	pthread_mutex_destroy(&_lock);
+}
+
+/**
+ * Queues a job to be run by some thread of the pool. The caller keeps ownership
+ * of the job and must keep it alive until wait() returns.
+ */
+void ThreadPool::submit(Job* job)
+{
+	Worker* worker = _workers[_nextWorker];
+	_nextWorker = (_nextWorker + 1) % _workers.size();
+	
+	pthread_mutex_lock(&worker->lock);
+	worker->jobs.push_back(job);
+	pthread_mutex_unlock(&worker->lock);
+	
+	pthread_mutex_lock(&_lock);
+	_queued++;
+	_unfinished++;
+	pthread_cond_signal(&_jobsQueued);
+	pthread_mutex_unlock(&_lock);
+}
+
+/**
+ * Helps run the submitted jobs, then waits until every one of them has finished.
+ */
+void ThreadPool::wait()
+{
+	int index = _workers.size() - 1;
+	Job* job;
+	while((job = take(index)) != NULL)
+	{
+		job->run();
+		finish();
+	}
+	
+	pthread_mutex_lock(&_lock);
+	while(_unfinished > 0)
+		pthread_cond_wait(&_jobsFinished, &_lock);
+	pthread_mutex_unlock(&_lock);
+}
+
+/**
+ * Takes the next job for the specified queue's thread: the newest job in its own queue,
+ * or else the oldest job in the first other queue that has one.
+ * Returns NULL if every queue is empty.
+ */
+Job* ThreadPool::take(int index)
+{
+	Job* job = NULL;
+	int count = _workers.size();
+	int i;
+	for(i = 0; i < count && job == NULL; i++)
+	{
+		Worker* worker = _workers[(index + i) % count];
+		pthread_mutex_lock(&worker->lock);
+		if(!worker->jobs.empty())
+		{
+			if(i == 0)
+			{
+				job = worker->jobs.back();
+				worker->jobs.pop_back();
+			}
+			else
+			{
+				job = worker->jobs.front();
+				worker->jobs.pop_front();
+			}
+		}
+		pthread_mutex_unlock(&worker->lock);
+	}
+	
+	if(job != NULL)
+	{
+		pthread_mutex_lock(&_lock);
+		_queued--;
+		pthread_mutex_unlock(&_lock);
+	}
+	return job;
+}
+
+/**
+ * Records that a taken job has finished running.
+ */
+void ThreadPool::finish()
+{
+	pthread_mutex_lock(&_lock);
+	_unfinished--;
+	if(_unfinished == 0)
+		pthread_cond_broadcast(&_jobsFinished);
+	pthread_mutex_unlock(&_lock);
+}
+
+/**
+ * The body of every worker thread: runs jobs until the pool stops,
+ * sleeping whenever there is nothing queued.
+ */
+void* ThreadPool::workerMain(void* arg)
+{
+	Worker* worker = (Worker*)arg;
+	ThreadPool* pool = worker->pool;
+	TRACE_THREAD("worker");
+	while(true)
+	{
+		pthread_mutex_lock(&pool->_lock);
+		while(pool->_queued == 0 && !pool->_stopping)
+			pthread_cond_wait(&pool->_jobsQueued, &pool->_lock);
+		bool stopping = pool->_stopping && pool->_queued == 0;
+		pthread_mutex_unlock(&pool->_lock);
+		if(stopping)
+			return NULL;
+		
+		Job* job = pool->take(worker->index);
+		if(job != NULL)
+		{
+			job->run();
+			pool->finish();
+		}
+	}
+}
+
+/**
+ * Returns the number of worker threads, not counting the thread that calls wait().
+ */
+int ThreadPool::threadCount()
+{
+	return _workers.size() - 1;
+}
+
+/**
+ * Returns the number of processor cores available, at least 1.
+ */
+int ThreadPool::coreCount()
+{
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? count : 1;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <pthread.h>
+#include <deque>
+
+/**
+ * A unit of work that can be run on a ThreadPool.
+ */
+class Job
+{
+public:
+	
+	virtual ~Job(){}
+	
+	virtual void run() = 0;
+};
+
+/**
+ * A fixed set of worker threads that run submitted jobs.
+ * Every worker has its own queue. Submitted jobs are dealt out to the queues in turn;
+ * a worker takes the newest job from its own queue and, when that is empty, steals
+ * the oldest job from another worker's queue, so a worker that finishes early keeps busy.
+ * The thread that calls wait() joins in with a queue of its own, so a pool with
+ * no workers simply runs every job on the calling thread.
+ * submit() and wait() must be called from one thread at a time.
+ */
+class ThreadPool
+{
+private:
+	
+	/**
+	 * A queue of jobs and, except for the caller's queue, the thread that owns it.
+	 */
+	struct Worker
+	{
+		ThreadPool* pool;
+		int index;
+		pthread_t thread;
+		pthread_mutex_t lock; // Guards the queue.
+		deque<Job*> jobs;
+	};
+	
+	vector<Worker*> _workers; // The last one is the queue of the thread that calls wait().
+	int _nextWorker;
+	pthread_mutex_t _lock; // Guards the counts and the stopping flag.
+	pthread_cond_t _jobsQueued;
+	pthread_cond_t _jobsFinished;
+	int _queued; // Jobs submitted and not yet taken.
+	int _unfinished; // Jobs submitted and not yet finished.
+	bool _stopping;
+	
+	Job* take(int index);
+	void finish();
+	static void* workerMain(void* arg);
+
+public:
+	
+	ThreadPool(int threadCount);
+	~ThreadPool();
+	
+	void submit(Job* job);
+	void wait();
+	
+	int threadCount();
+	
+	static int coreCount();
+};
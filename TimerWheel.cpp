@@ -0,0 +1,262 @@
+#include "TimerWheel.h"
+
+/**
+ * Orders due timer nodes by the order in which they were scheduled.
+ */
+struct ScheduledBefore
+{
+	vector<TimerNode>* nodes;
+	bool operator()(int a, int b) const {return (*nodes)[a].seq < (*nodes)[b].seq;}
+};
+
+/**
+ * Packs a node index and generation into a TimerId.
+ */
+static TimerId makeId(int index, int generation)
+{
+	return ((TimerId)generation << 32) | (unsigned int)index;
+}
+
+/**
+ * Creates a new, empty TimerWheel positioned at frame 0.
+ */
+TimerWheel::TimerWheel()
+{
+	_freeHead = -1;
+	_now = 0;
+	_seq = 0;
+	_count = 0;
+	
+	int i;
+	for(i = 0; i < LEVELS * SLOTS; i++)
+		_heads[i] = -1;
+}
+
+/**
+ * Schedules a timer.
+ * @param frame The frame at which to fire. Frames that have already been
+ * reached fire on the next frame.
+ * @param listener The object whose timerFired method will be called.
+ * @param tag The value passed to timerFired.
+ * @return An id that can be used to cancel the timer.
+ */
+TimerId TimerWheel::schedule(int frame, TimerListener* listener, int tag)
+{
+	int index;
+	if(_freeHead >= 0)
+	{
+		index = _freeHead;
+		_freeHead = _nodes[index].next;
+	}
+	else
+	{
+		index = _nodes.size();
+		_nodes.push_back(TimerNode());
+		_nodes[index].generation = 0;
+	}
+	
+	TimerNode& node = _nodes[index];
+	node.frame = max(frame, _now + 1);
+	node.seq = _seq++;
+	node.tag = tag;
+	node.listener = listener;
+	node.generation++;
+	link(index);
+	_count++;
+	
+	return makeId(index, node.generation);
+}
+
+/**
+ * Cancels a timer. Does nothing if the timer has already fired or been cancelled.
+ */
+void TimerWheel::cancel(TimerId id)
+{
+	if(!isScheduled(id))
+		return;
+	
+	int index = (int)(id & 0xffffffff);
+	if(_nodes[index].slot >= 0)
+		unlink(index);
+	release(index);
+}
+
+/**
+ * Returns whether the specified timer is still waiting to fire.
+ */
+bool TimerWheel::isScheduled(TimerId id)
+{
+	int index = (int)(id & 0xffffffff);
+	int generation = (int)(id >> 32);
+	return id != 0 && index < (int)_nodes.size() &&
+	       _nodes[index].generation == generation && _nodes[index].listener != NULL;
+}
+
+/**
+ * Fires, in order, every timer due up to and including the specified frame.
+ * Listeners may schedule and cancel timers while they are being notified.
+ */
+void TimerWheel::advance(int frame)
+{
+	vector<int> due;
+	vector<TimerId> dueIds;
+	while(_now < frame)
+	{
+		_now++;
+		
+		// When a level's slot index wraps around, redistribute the next
+		// slot of the level above into the levels below.
+		int level;
+		for(level = 1; level < LEVELS; level++)
+		{
+			if((_now & ((1 << (SLOT_BITS * level)) - 1)) != 0)
+				break;
+			cascade(level);
+		}
+		
+		// Everything in the current bottom slot is due now.
+		int slot = _now & (SLOTS - 1);
+		if(_heads[slot] < 0)
+			continue;
+		
+		due.clear();
+		while(_heads[slot] >= 0)
+		{
+			int index = _heads[slot];
+			unlink(index);
+			due.push_back(index);
+		}
+		ScheduledBefore before;
+		before.nodes = &_nodes;
+		sort(due.begin(), due.end(), before);
+		dueIds.clear();
+		vector<int>::iterator iter;
+		for(iter = due.begin(); iter != due.end(); ++iter)
+			dueIds.push_back(makeId(*iter, _nodes[*iter].generation));
+		
+		vector<TimerId>::iterator idIter;
+		for(idIter = dueIds.begin(); idIter != dueIds.end(); ++idIter)
+		{
+			// A listener earlier in the list may have cancelled this timer.
+			if(!isScheduled(*idIter))
+				continue;
+			int index = (int)(*idIter & 0xffffffff);
+			TimerListener* listener = _nodes[index].listener;
+			int tag = _nodes[index].tag;
+			release(index);
+			listener->timerFired(tag);
+		}
+	}
+}
+
+/**
+ * Cancels every timer without firing it.
+ */
+void TimerWheel::clear()
+{
+	int i;
+	for(i = 0; i < (int)_nodes.size(); i++)
+	{
+		if(_nodes[i].listener != NULL)
+		{
+			if(_nodes[i].slot >= 0)
+				unlink(i);
+			release(i);
+		}
+	}
+}
+
+/**
+ * Cancels every timer and repositions the wheel at the specified frame,
+ * as if it had just been advanced to it.
+ */
+void TimerWheel::reset(int frame)
+{
+	clear();
+	_now = frame;
+}
+
+/**
+ * Returns the last frame that has been advanced to.
+ */
+int TimerWheel::now()
+{
+	return _now;
+}
+
+/**
+ * Returns the number of timers waiting to fire.
+ */
+int TimerWheel::count()
+{
+	return _count;
+}
+
+/**
+ * Links a node into the slot of the lowest level whose span covers its frame.
+ * Timers too far in the future for the top level go in its furthest slot and
+ * are placed again when that slot cascades.
+ */
+void TimerWheel::link(int index)
+{
+	TimerNode& node = _nodes[index];
+	int delta = node.frame - _now;
+	int level = 0;
+	while(level < LEVELS - 1 && delta >= (1 << (SLOT_BITS * (level + 1))))
+		level++;
+	
+	int frame = node.frame;
+	if(delta >= (1 << (SLOT_BITS * LEVELS)) - 1)
+		frame = _now + (1 << (SLOT_BITS * LEVELS)) - 1;
+	int slot = level * SLOTS + ((frame >> (SLOT_BITS * level)) & (SLOTS - 1));
+	
+	node.slot = slot;
+	node.prev = -1;
+	node.next = _heads[slot];
+	if(node.next >= 0)
+		_nodes[node.next].prev = index;
+	_heads[slot] = index;
+}
+
+/**
+ * Unlinks a node from the slot it is in.
+ */
+void TimerWheel::unlink(int index)
+{
+	TimerNode& node = _nodes[index];
+	if(node.prev >= 0)
+		_nodes[node.prev].next = node.next;
+	else
+		_heads[node.slot] = node.next;
+	if(node.next >= 0)
+		_nodes[node.next].prev = node.prev;
+	node.slot = -1;
+}
+
+/**
+ * Returns an unlinked node to the free list.
+ */
+void TimerWheel::release(int index)
+{
+	TimerNode& node = _nodes[index];
+	node.listener = NULL;
+	node.next = _freeHead;
+	_freeHead = index;
+	_count--;
+}
+
+/**
+ * Moves every node in the current slot of the specified level down to lower levels.
+ */
+void TimerWheel::cascade(int level)
+{
+	int slot = level * SLOTS + ((_now >> (SLOT_BITS * level)) & (SLOTS - 1));
+	int index = _heads[slot];
+	_heads[slot] = -1;
+	while(index >= 0)
+	{
+		int next = _nodes[index].next;
+		link(index);
+		index = next;
+	}
+}
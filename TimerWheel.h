@@ -0,0 +1,76 @@
+#pragma once
+
+/**
+ * Identifies a timer scheduled on a TimerWheel. Zero never identifies a timer.
+ */
+typedef long long TimerId;
+
+/**
+ * The interface for objects that receive timers from a TimerWheel.
+ */
+class TimerListener
+{
+public:
+	
+	virtual ~TimerListener(){}
+	virtual void timerFired(int tag) = 0;
+};
+
+/**
+ * A single timer stored in the TimerWheel's node pool.
+ */
+struct TimerNode
+{
+	int frame; // The frame at which the timer fires.
+	int seq; // The order in which the timer was scheduled, used to break ties.
+	int tag; // Passed back to the listener when the timer fires.
+	TimerListener* listener; // The object to notify, or NULL if the node is free.
+	int generation; // Incremented each time the node is reused, to detect stale TimerIds.
+	int prev; // The previous node in the slot or free list, or -1.
+	int next; // The next node in the slot or free list, or -1.
+	int slot; // The slot this node is linked into, or -1 if it is free or about to fire.
+};
+
+/**
+ * A hierarchical timer wheel keyed on frame numbers.
+ * Scheduling and cancelling are O(1), and advancing by one frame only touches
+ * the timers due that frame, plus an occasional cascade of a higher-level slot.
+ * Timers due on the same frame fire in the order they were scheduled.
+ */
+class TimerWheel
+{
+private:
+	
+	enum
+	{
+		SLOT_BITS = 6,
+		SLOTS = 1 << SLOT_BITS,
+		LEVELS = 4
+	};
+	
+	vector<TimerNode> _nodes;
+	int _heads[LEVELS * SLOTS];
+	int _freeHead;
+	int _now;
+	int _seq;
+	int _count;
+	
+	void link(int index);
+	void unlink(int index);
+	void release(int index);
+	void cascade(int level);
+	
+public:
+	
+	TimerWheel();
+	
+	TimerId schedule(int frame, TimerListener* listener, int tag);
+	void cancel(TimerId id);
+	bool isScheduled(TimerId id);
+	void advance(int frame);
+	void clear();
+	void reset(int frame);
+	
+	int now();
+	int count();
+};
@@ -0,0 +1,266 @@
+#include "Trace.h"
+#include "Stopwatch.h"
+#include <pthread.h>
+#include <string.h>
+
+#define TRACE_BUFFER_MASK (TRACE_BUFFER_EVENTS - 1)
+
+static pthread_once_t traceOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t traceKey; // Each thread's TraceBuffer.
+static TraceBuffer* volatile traceBuffers = NULL; // The newest buffer, linked to the older ones.
+static pthread_mutex_t traceLock = PTHREAD_MUTEX_INITIALIZER; // Guards adding buffers to the list.
+static int traceThreads = 0; // The number of threads that have traced anything.
+static long long traceStartMicros; // Event times are saved relative to this.
+static pthread_mutex_t traceFlushLock = PTHREAD_MUTEX_INITIALIZER; // Guards flushing.
+static bool traceFlushed = false; // Whether the trace has been started.
+static vector<TraceEvent> traceEvents; // Room to copy a buffer's events into while flushing.
+
+/**
+ * Sets up what the threads share. Called once, by whichever thread traces first.
+ */
+static void setupTracing()
+{
+	pthread_key_create(&traceKey, NULL);
+	traceStartMicros = Stopwatch::nowMicros();
+}
+
+/**
+ * Creates an empty buffer.
+ * @param thread The number of the thread that owns the buffer.
+ * @param next The buffer of the thread that started tracing before this one, or NULL.
+ */
+TraceBuffer::TraceBuffer(int thread, TraceBuffer* next)
+{
+	_written = 0;
+	_thread = thread;
+	_threadName = NULL;
+	_next = next;
+	_flushed = 0;
+	_dropped = 0;
+	_depth = 0;
+	_nameFlushed = false;
+}
+
+/**
+ * Records an event at the current time, overwriting the oldest once the ring
+ * is full. Called by the owning thread only.
+ */
+void TraceBuffer::record(const char* name, char phase)
+{
+	// Fill the event before publishing it.
+	TraceEvent& event = _events[_written & TRACE_BUFFER_MASK];
+	event.name = name;
+	event.phase = phase;
+	event.micros = Stopwatch::nowMicros();
+	__sync_fetch_and_add(&_written, 1);
+}
+
+/**
+ * Sets the name the owning thread is shown with.
+ */
+void TraceBuffer::setThreadName(const char* name)
+{
+	_threadName = name;
+}
+
+/**
+ * Returns the number of events overwritten before they could be flushed, so far.
+ */
+int TraceBuffer::dropped()
+{
+	return _dropped;
+}
+
+/**
+ * Returns the buffer of the thread that started tracing before this one, or NULL.
+ */
+TraceBuffer* TraceBuffer::next()
+{
+	return _next;
+}
+
+/**
+ * Copies the events recorded since the last flush, oldest first, and moves
+ * the flush past them.
+ * @param events Where to copy the events. Must have room for TRACE_BUFFER_EVENTS.
+ * @param skipped Set to the number of events overwritten before they could be copied.
+ * Returns the number of events copied.
+ */
+int TraceBuffer::copy(TraceEvent* events, int* skipped)
+{
+	unsigned int written = _written;
+	__sync_synchronize();
+	unsigned int first = _flushed;
+	if(written - first > TRACE_BUFFER_EVENTS)
+		first = written - TRACE_BUFFER_EVENTS;
+	int count = written - first;
+	int i;
+	for(i = 0; i < count; i++)
+		events[i] = _events[(first + i) & TRACE_BUFFER_MASK];
+	
+	// The owner may have overwritten the oldest events while they were being copied.
+	// An event is overwritten before the count is bumped, so any event a whole
+	// ring's length or more behind the count now may be torn.
+	__sync_synchronize();
+	unsigned int after = _written;
+	int torn = 0;
+	while(torn < count && after - (first + torn) >= TRACE_BUFFER_EVENTS)
+		torn++;
+	if(torn > 0)
+		memmove(events, events + torn, (count - torn) * sizeof(TraceEvent));
+	
+	*skipped = first + torn - _flushed;
+	_flushed = written;
+	return count - torn;
+}
+
+/**
+ * Writes the events recorded since the last flush to the specified file as
+ * Chrome trace events, each followed by a comma. Where events were overwritten
+ * before they could be flushed, writes an instant event with the number lost,
+ * and leaves out any ends whose begins were lost. Only Tracer::flush calls this.
+ * @param events Room for TRACE_BUFFER_EVENTS events to copy into.
+ * Returns the number of events written.
+ */
+int TraceBuffer::flush(FILE* file, TraceEvent* events)
+{
+	const char* name = _threadName;
+	if(name != NULL && !_nameFlushed)
+	{
+		fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}},\n",
+				_thread, name);
+		_nameFlushed = true;
+	}
+	
+	int skipped;
+	int count = copy(events, &skipped);
+	if(skipped > 0)
+	{
+		long long micros = count > 0 ? events[0].micros : Stopwatch::nowMicros();
+		fprintf(file, "{\"name\":\"trace dropped events\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%lld,\"args\":{\"dropped\":%d}},\n",
+				_thread, micros - traceStartMicros, skipped);
+		_dropped += skipped;
+	}
+	
+	int written = 0;
+	int i;
+	for(i = 0; i < count; i++)
+	{
+		const TraceEvent& event = events[i];
+		if(event.phase == 'B')
+		{
+			_depth++;
+		}
+		else if(event.phase == 'E')
+		{
+			if(_depth == 0)
+				continue;
+			_depth--;
+		}
+		fprintf(file, "{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":1,\"tid\":%d,\"ts\":%lld%s},\n",
+				event.name, event.phase, _thread, event.micros - traceStartMicros,
+				event.phase == 'i' ? ",\"s\":\"t\"" : "");
+		written++;
+	}
+	return written;
+}
+
+/**
+ * Returns the calling thread's buffer, making it and adding it to the list the
+ * first time, which is the only time a thread takes a lock. Buffers are never
+ * freed, so a thread's events can still be saved after it has finished.
+ */
+TraceBuffer* Tracer::buffer()
+{
+	pthread_once(&traceOnce, setupTracing);
+	TraceBuffer* buffer = (TraceBuffer*)pthread_getspecific(traceKey);
+	if(buffer != NULL)
+		return buffer;
+	
+	pthread_mutex_lock(&traceLock);
+	traceThreads++;
+	buffer = new TraceBuffer(traceThreads, traceBuffers);
+	traceBuffers = buffer;
+	pthread_mutex_unlock(&traceLock);
+	pthread_setspecific(traceKey, buffer);
+	return buffer;
+}
+
+/**
+ * Begins an event on the calling thread. Every begin must be matched by an end.
+ * @param name A string literal, or any string that will outlive the trace.
+ */
+void Tracer::begin(const char* name)
+{
+	buffer()->record(name, 'B');
+}
+
+/**
+ * Ends the calling thread's latest event that hasn't ended.
+ */
+void Tracer::end(const char* name)
+{
+	buffer()->record(name, 'E');
+}
+
+/**
+ * Records an event with no duration on the calling thread.
+ */
+void Tracer::instant(const char* name)
+{
+	buffer()->record(name, 'i');
+}
+
+/**
+ * Sets the name the calling thread is shown with in the trace.
+ */
+void Tracer::nameThread(const char* name)
+{
+	buffer()->setThreadName(name);
+}
+
+/**
+ * Appends the events every thread has recorded since the last flush to the
+ * trace at the specified path, starting the trace on the first flush.
+ * Threads may go on recording meanwhile; their later events are left for the
+ * next flush. Any thread may flush, one at a time. Returns whether the events
+ * were written.
+ */
+bool Tracer::flush(const char* path)
+{
+	pthread_once(&traceOnce, setupTracing);
+	pthread_mutex_lock(&traceFlushLock);
+	FILE* file = fopen(path, traceFlushed ? "a" : "w");
+	if(file == NULL)
+	{
+		pthread_mutex_unlock(&traceFlushLock);
+		return false;
+	}
+	if(!traceFlushed)
+		fprintf(file, "[\n");
+	traceFlushed = true;
+	
+	if(traceEvents.empty())
+		traceEvents.resize(TRACE_BUFFER_EVENTS);
+	// Taking the list under its lock makes sure every buffer on it is fully made.
+	pthread_mutex_lock(&traceLock);
+	TraceBuffer* buffers = traceBuffers;
+	pthread_mutex_unlock(&traceLock);
+	
+	int events = 0;
+	int dropped = 0;
+	TraceBuffer* buffer;
+	for(buffer = buffers; buffer != NULL; buffer = buffer->next())
+	{
+		int before = buffer->dropped();
+		events += buffer->flush(file, &traceEvents[0]);
+		dropped += buffer->dropped() - before;
+	}
+	
+	bool written = ferror(file) == 0;
+	fclose(file);
+	pthread_mutex_unlock(&traceFlushLock);
+	if(dropped > 0)
+		printf("trace: %d events flushed to %s, %d dropped\n", events, path, dropped);
+	return written;
+}
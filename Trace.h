@@ -0,0 +1,109 @@
+#pragma once
+
+#include "rules.h"
+#include <stdio.h>
+
+/**
+ * A single traced event.
+ */
+struct TraceEvent
+{
+	const char* name; // A string literal, so that recording it copies nothing.
+	char phase; // The Chrome trace phase: 'B' for begin, 'E' for end, or 'i' for instant.
+	long long micros; // When the event happened, on the Stopwatch clock.
+};
+
+/**
+ * A ring of the latest TRACE_BUFFER_EVENTS events recorded by one thread.
+ * Only the owning thread writes events, overwriting the oldest once the ring is
+ * full, and it publishes each one by atomically bumping the count, so recording
+ * never takes a lock or waits. Flushing copies the events recorded since the
+ * last flush from any thread, in the same way a TelemetryRing is read: any event
+ * the owner could have overwritten meanwhile is thrown away, and counted as dropped.
+ */
+class TraceBuffer
+{
+private:
+	
+	TraceEvent _events[TRACE_BUFFER_EVENTS];
+	volatile unsigned int _written; // The number of events ever recorded. Written by the owning thread.
+	int _thread; // A number that tells the threads apart in the trace, from 1.
+	const char* volatile _threadName;
+	TraceBuffer* _next; // The buffer of the thread that started tracing before this one.
+	unsigned int _flushed; // The number of the next event to flush. Used by flush() only.
+	int _dropped; // The number of events overwritten before they could be flushed.
+	int _depth; // The number of events flushed that have begun but not ended.
+	bool _nameFlushed; // Whether the thread's name has been flushed.
+	
+	int copy(TraceEvent* events, int* skipped);
+
+public:
+	
+	TraceBuffer(int thread, TraceBuffer* next);
+	
+	void record(const char* name, char phase);
+	
+	void setThreadName(const char* name);
+	int dropped();
+	TraceBuffer* next();
+	
+	int flush(FILE* file, TraceEvent* events);
+};
+
+/**
+ * Records what each thread is doing, for viewing on a timeline, through the
+ * TRACE_ macros below. With TRACING off they compile to nothing.
+ * Each thread records into a TraceBuffer of its own, made the first time it
+ * records anything, which keeps its latest events. Flushing appends the events
+ * every thread has recorded since the last flush to a Chrome trace, which both
+ * chrome://tracing and Perfetto open, so flushing every so often keeps the whole
+ * run however long it goes on. The trace is a JSON array left open at the end,
+ * which both viewers accept, so it can be opened between flushes or after a crash.
+ */
+class Tracer
+{
+private:
+	
+	static TraceBuffer* buffer();
+
+public:
+	
+	static void begin(const char* name);
+	static void end(const char* name);
+	static void instant(const char* name);
+	static void nameThread(const char* name);
+	
+	static bool flush(const char* path);
+};
+
+/**
+ * Traces the lifetime of a block: begins an event when created and ends it when destroyed.
+ */
+class TraceScope
+{
+private:
+	
+	const char* _name;
+
+public:
+	
+	TraceScope(const char* name) : _name(name) {Tracer::begin(name);}
+	~TraceScope() {Tracer::end(_name);}
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#if TRACING
+#define TRACE_BEGIN(name) Tracer::begin(name)
+#define TRACE_END(name) Tracer::end(name)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_INSTANT(name) Tracer::instant(name)
+#define TRACE_THREAD(name) Tracer::nameThread(name)
+#else
+#define TRACE_BEGIN(name)
+#define TRACE_END(name)
+#define TRACE_SCOPE(name)
+#define TRACE_INSTANT(name)
+#define TRACE_THREAD(name)
+#endif
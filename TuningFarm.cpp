@@ -0,0 +1,191 @@
+#include "TuningFarm.h"
+#include "Game.h"
+#include "GenericLevel.h"
+#include "GravityPolicy.h"
+#include "FrameStats.h"
+#include "Stopwatch.h"
+#include "rules.h"
+#include <string.h>
+
+/**
+ * Creates a game to be played by a TuningFarm.
+ * @param level The 1-based number of the level to play.
+ * @param seed The seed for the game's random numbers and, if random, its gravity. Not 0.
+ * @param gravity How the game's gravity is decided.
+ * @param maxFrames The number of frames after which the game is abandoned.
+ */
+TuningGame::TuningGame(int level, unsigned int seed, TuningGravity gravity, int maxFrames)
+{
+	_level = level;
+	_seed = seed;
+	_gravity = gravity;
+	_maxFrames = maxFrames;
+	memset(&_result, 0, sizeof(_result));
+}
+
+/**
+ * Plays the game until it is won, lost, or abandoned, recording the result.
+ */
+void TuningGame::run()
+{
+	Game game(NULL, shared_ptr<LevelBase>(new GenericLevel(levels[_level - 1])), _seed);
+	if(_gravity == TUNING_GRAVITY_AIMED)
+	{
+		AimedGravity* policy = new AimedGravity(&game, TUNING_GRAVITY_MAX, TUNING_AIM_FLIGHT_FRAMES);
+		game.setGravityPolicy(shared_ptr<GravityPolicy>(policy));
+	}
+	else if(_gravity == TUNING_GRAVITY_SCRIPTED)
+	{
+		ScriptedGravity* policy = ScriptedGravity::turning(TUNING_GRAVITY_HOLD_FRAMES, TUNING_GRAVITY_MAX);
+		game.setGravityPolicy(shared_ptr<GravityPolicy>(policy));
+	}
+	else
+	{
+		RandomGravity* policy = new RandomGravity(_seed, TUNING_GRAVITY_HOLD_FRAMES, TUNING_GRAVITY_MAX);
+		game.setGravityPolicy(shared_ptr<GravityPolicy>(policy));
+	}
+	
+	while(_result.frames < _maxFrames && !game.isWon() && !game.isLost())
+	{
+		game.update();
+		_result.frames++;
+		
+		long long micros = game.stats()->updateMicros;
+		_result.totalTickMicros += micros;
+		_result.maxTickMicros = max(_result.maxTickMicros, micros);
+		
+		int objects = game.gameObjectsEnd() - game.gameObjectsBegin();
+		int enemies = game.enemyCount();
+		int bullets = game.bulletsEnd() - game.bulletsBegin();
+		_result.peakObjects = max(_result.peakObjects, objects);
+		_result.peakEnemies = max(_result.peakEnemies, enemies);
+		_result.peakBullets = max(_result.peakBullets, bullets);
+	}
+	_result.won = game.isWon();
+	_result.lost = game.isLost();
+}
+
+/**
+ * Returns the 1-based number of the level this game plays.
+ */
+int TuningGame::level()
+{
+	return _level;
+}
+
+/**
+ * Returns the result of the game. Valid once run() has returned.
+ */
+TuningResult* TuningGame::result()
+{
+	return &_result;
+}
+
+/**
+ * Creates a new TuningFarm.
+ * @param gamesPerLevel The number of games to play on each level.
+ * @param threadCount The number of threads to play them on, including the calling thread.
+ * @param gravity How the gravity of every game is decided.
+ */
+TuningFarm::TuningFarm(int gamesPerLevel, int threadCount, TuningGravity gravity)
+{
+	_gamesPerLevel = gamesPerLevel;
+	_threadCount = max(threadCount, 1);
+	_gravity = gravity;
+	_maxFrames = TUNING_MAX_FRAMES;
+	_elapsedMicros = 0;
+}
+
+/**
+ * Plays every game and aggregates the results by level.
+ * All levels are submitted at once so that no thread idles between levels.
+ */
+void TuningFarm::run()
+{
+	Stopwatch stopwatch;
+	
+	vector<TuningGame*> games;
+	int level;
+	int i;
+	for(level = 1; level <= LEVEL_COUNT; level++)
+	{
+		for(i = 0; i < _gamesPerLevel; i++)
+		{
+			unsigned int seed = TUNING_SEED + (level - 1) * _gamesPerLevel + i;
+			games.push_back(new TuningGame(level, seed, _gravity, _maxFrames));
+		}
+	}
+	
+	ThreadPool pool(_threadCount - 1);
+	for(i = 0; i < (int)games.size(); i++)
+		pool.submit(games[i]);
+	pool.wait();
+	
+	_reports.resize(LEVEL_COUNT);
+	memset(&_reports[0], 0, sizeof(TuningLevelReport) * LEVEL_COUNT);
+	for(i = 0; i < (int)games.size(); i++)
+	{
+		TuningLevelReport* report = &_reports[games[i]->level() - 1];
+		TuningResult* result = games[i]->result();
+		report->level = games[i]->level();
+		report->games++;
+		if(result->won)
+		{
+			report->wins++;
+			report->winFrames += result->frames;
+		}
+		if(result->lost)
+			report->losses++;
+		report->peakObjects = max(report->peakObjects, result->peakObjects);
+		report->peakEnemies = max(report->peakEnemies, result->peakEnemies);
+		report->peakBullets = max(report->peakBullets, result->peakBullets);
+		report->totalTicks += result->frames;
+		report->totalTickMicros += result->totalTickMicros;
+		report->maxTickMicros = max(report->maxTickMicros, result->maxTickMicros);
+		delete games[i];
+	}
+	
+	_elapsedMicros = stopwatch.elapsedMicros();
+}
+
+/**
+ * Prints the report of every level, then the farm's own throughput.
+ */
+void TuningFarm::print()
+{
+	int i;
+	for(i = 0; i < (int)_reports.size(); i++)
+	{
+		TuningLevelReport* report = &_reports[i];
+		float winRate = report->games > 0 ? 100.0f * report->wins / report->games : 0;
+		float loseRate = report->games > 0 ? 100.0f * report->losses / report->games : 0;
+		float winFrames = report->wins > 0 ? (float)report->winFrames / report->wins : 0;
+		float tickMicros = report->totalTicks > 0 ? (float)report->totalTickMicros / report->totalTicks : 0;
+		printf("tune: level %d, %d games, won %.1f%%, lost %.1f%%, %.0f frames to win, "
+			   "peak %d objects %d enemies %d bullets, tick %.1fus avg %lldus max\n",
+			   report->level, report->games, winRate, loseRate, winFrames,
+			   report->peakObjects, report->peakEnemies, report->peakBullets,
+			   tickMicros, report->maxTickMicros);
+	}
+	
+	int games = _gamesPerLevel * LEVEL_COUNT;
+	float seconds = _elapsedMicros / 1000000.0f;
+	printf("tune: %d games on %d threads in %.2fs, %.0f games/sec\n",
+		   games, _threadCount, seconds, seconds > 0 ? games / seconds : 0);
+}
+
+/**
+ * Returns the report of the specified 1-based level. Valid once run() has returned.
+ */
+TuningLevelReport* TuningFarm::report(int level)
+{
+	return &_reports[level - 1];
+}
+
+/**
+ * Returns the wall-clock time taken by run().
+ */
+long long TuningFarm::elapsedMicros()
+{
+	return _elapsedMicros;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "ThreadPool.h"
+
+/**
+ * How the gravity of the games played by a TuningFarm is decided.
+ */
+enum TuningGravity
+{
+	TUNING_GRAVITY_AIMED, // Every game tilts to bend its shots onto the nearest enemy, as a person would.
+	TUNING_GRAVITY_SCRIPTED, // Every game turns gravity through the same fixed script.
+	TUNING_GRAVITY_RANDOM // Every game holds random gravities picked from its seed.
+};
+
+/**
+ * The outcome and cost of a single headless game.
+ */
+struct TuningResult
+{
+	bool won; // Whether the game was won within the frame limit.
+	bool lost; // Whether the game was lost within the frame limit.
+	int frames; // The number of frames played.
+	int peakObjects; // The most GameObjects in the game at once.
+	int peakEnemies; // The most enemies in the game at once, awake or asleep.
+	int peakBullets; // The most bullets in the game at once.
+	long long totalTickMicros; // The time spent updating the game.
+	long long maxTickMicros; // The time spent on the slowest update.
+};
+
+/**
+ * The results of every game played on one level, aggregated.
+ */
+struct TuningLevelReport
+{
+	int level; // The 1-based level number.
+	int games; // The number of games played.
+	int wins; // The number of games won.
+	int losses; // The number of games lost. The rest hit the frame limit.
+	long long winFrames; // The total frames taken by the games that were won.
+	int peakObjects; // The most GameObjects in any game at once.
+	int peakEnemies; // The most enemies in any game at once.
+	int peakBullets; // The most bullets in any game at once.
+	long long totalTicks; // The number of updates across every game.
+	long long totalTickMicros; // The time spent on those updates.
+	long long maxTickMicros; // The time spent on the slowest of them.
+};
+
+/**
+ * A job that plays one seeded game of one level without drawing it.
+ * Each game builds everything it touches, so any number can run at once.
+ */
+class TuningGame : public Job
+{
+private:
+	
+	int _level;
+	unsigned int _seed;
+	TuningGravity _gravity;
+	int _maxFrames;
+	TuningResult _result;
+
+public:
+	
+	TuningGame(int level, unsigned int seed, TuningGravity gravity, int maxFrames);
+	
+	void run();
+	
+	int level();
+	TuningResult* result();
+};
+
+/**
+ * Plays many seeded games of every level in parallel and reports, per level,
+ * the win rate, time to win, peak object counts, and tick cost,
+ * for balancing the rules in levels.cpp without a device.
+ * Every game's seed depends only on its level and index, so the same farm
+ * settings always play the same games, whatever the number of threads.
+ */
+class TuningFarm
+{
+private:
+	
+	int _gamesPerLevel;
+	int _threadCount;
+	TuningGravity _gravity;
+	int _maxFrames;
+	vector<TuningLevelReport> _reports;
+	long long _elapsedMicros;
+
+public:
+	
+	TuningFarm(int gamesPerLevel, int threadCount, TuningGravity gravity);
+	
+	void run();
+	void print();
+	
+	TuningLevelReport* report(int level);
+	long long elapsedMicros();
+};
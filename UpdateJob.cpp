@@ -0,0 +1,78 @@
+#include "UpdateJob.h"
+#include "Game.h"
+#include "Enemy.h"
+#include "Bullet.h"
+#include "Trace.h"
+
+/**
+ * Creates a job that does nothing until setup() is called.
+ */
+UpdateJob::UpdateJob()
+{
+	_game = NULL;
+	_phase = UPDATE_PHASE_STEER;
+	_begin = 0;
+	_end = 0;
+	_collisionTests = 0;
+}
+
+/**
+ * Points this job at a chunk of objects.
+ * @param game The game being updated.
+ * @param phase The part of the frame to run.
+ * @param begin The index of the first object of the chunk: a GameObject for
+ * UPDATE_PHASE_STEER, or a bullet for UPDATE_PHASE_BULLETS.
+ * @param end The index just past the last object of the chunk.
+ */
+void UpdateJob::setup(Game* game, UpdatePhase phase, int begin, int end)
+{
+	_game = game;
+	_phase = phase;
+	_begin = begin;
+	_end = end;
+	_collisionTests = 0;
+	_commands.clear();
+}
+
+/**
+ * Runs the phase over the chunk.
+ */
+void UpdateJob::run()
+{
+	TRACE_SCOPE(_phase == UPDATE_PHASE_STEER ? "steer" : "bullets");
+	int i;
+	if(_phase == UPDATE_PHASE_STEER)
+	{
+		GameObjectIter gobjects = _game->gameObjectsBegin();
+		for(i = _begin; i < _end; i++)
+		{
+			GameObject* gobject = gobjects[i].get();
+			GameObjectType type = gobject->type();
+			if(type == GAMEOBJECT_ENEMY)
+				static_cast<Enemy*>(gobject)->steer(&_commands);
+		}
+	}
+	else
+	{
+		vector<Bullet*>::iterator bullets = _game->bulletsBegin();
+		for(i = _begin; i < _end; i++)
+			bullets[i]->advance(&_commands, &_collisionTests);
+	}
+}
+
+/**
+ * Returns the number of bullet/enemy pairs tested by the latest run.
+ */
+int UpdateJob::collisionTests()
+{
+	return _collisionTests;
+}
+
+
+/**
+ * Returns the commands recorded by the latest run, in the order the objects were added.
+ */
+CommandBuffer* UpdateJob::commands()
+{
+	return &_commands;
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "ThreadPool.h"
+#include "CommandBuffer.h"
+
+class Game;
+
+/**
+ * The parts of a frame that the game can run on many threads at once.
+ */
+enum UpdatePhase
+{
+	UPDATE_PHASE_STEER, // Moves the dust and steers the enemies, over a range of GameObjects.
+	UPDATE_PHASE_BULLETS // Advances the bullets and finds what they hit, over a range of bullets.
+};
+
+/**
+ * Runs one phase of a frame over one chunk of a game's objects,
+ * recording the hits and sleeps it finds in a command buffer of its own.
+ * Jobs are reused from frame to frame.
+ */
+class UpdateJob : public Job
+{
+private:
+	
+	Game* _game;
+	UpdatePhase _phase;
+	int _begin;
+	int _end;
+	int _collisionTests;
+	CommandBuffer _commands;
+
+public:
+	
+	UpdateJob();
+	
+	void setup(Game* game, UpdatePhase phase, int begin, int end);
+	void run();
+	
+	int collisionTests();
+	CommandBuffer* commands();
+};
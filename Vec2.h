@@ -0,0 +1,38 @@
+#pragma once
+
+#include <math.h>
+
+/**
+ * A 2D vector used for all simulation state: locations, velocities, and the like.
+ * Unlike ofPoint it carries no unused z coordinate, so it is 8 bytes instead of 12,
+ * and every operation is defined inline so the update loops compile to plain float math.
+ * Locations are handed to openFrameworks as their x and y components when drawing.
+ */
+struct Vec2
+{
+	float x;
+	float y;
+	
+	Vec2() : x(0), y(0) {}
+	Vec2(float x, float y) : x(x), y(y) {}
+	
+	Vec2 operator+(const Vec2& v) const {return Vec2(x + v.x, y + v.y);}
+	Vec2 operator-(const Vec2& v) const {return Vec2(x - v.x, y - v.y);}
+	Vec2 operator-() const {return Vec2(-x, -y);}
+	Vec2 operator*(float f) const {return Vec2(x * f, y * f);}
+	Vec2 operator/(float f) const {return Vec2(x / f, y / f);}
+	
+	Vec2& operator+=(const Vec2& v) {x += v.x; y += v.y; return *this;}
+	Vec2& operator-=(const Vec2& v) {x -= v.x; y -= v.y; return *this;}
+	Vec2& operator*=(float f) {x *= f; y *= f; return *this;}
+	Vec2& operator/=(float f) {x /= f; y /= f; return *this;}
+	
+	bool operator==(const Vec2& v) const {return x == v.x && y == v.y;}
+	bool operator!=(const Vec2& v) const {return x != v.x || y != v.y;}
+	
+	float dot(const Vec2& v) const {return x * v.x + y * v.y;}
+	float lengthSquared() const {return x * x + y * y;}
+	float length() const {return sqrt(x * x + y * y);}
+	
+	ofPoint toPoint() const {return ofPoint(x, y);}
+};
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "Player.h"
 #include "Bullet.h"
 #include "Enemy.h"
+#include "SpawnWave.h"
 
 /**
  * This file is procedurally generated by a python script from the level definitions.
@@ -14,18 +15,19 @@ BulletRules level1Player1BulletRules =
 	7, // radius
 	0.8, // gravity factor
 };
+Vec2 level1Player1Locs[] =
+{
+	Vec2(160, 240),
+};
 PlayerRules level1Player1Rules =
 {
-	// waypoints
-	{
-		ofPoint(160, 240),
-	},
+	level1Player1Locs, // waypoints
 	1, // waypoint count
 	0.5, // speed
 	0, // initial rotation
 	0, // rotational velocity
 	48, // fire interval
-	ofPoint(0, -12), // fire velocity
+	Vec2(0, -12), // fire velocity
 	&level1Player1BulletRules,
 };
 EnemyRules level1EnemyRules =
@@ -46,6 +48,8 @@ GenericLevelRules level1Rules =
 	255, // gravity arrow alpha
 	255, // path projection alpha
 	100, // path projection count
+	NULL, // spawn waves
+	0, // spawn wave count
 };
 
 // LEVEL 2
@@ -54,18 +58,19 @@ BulletRules level2Player1BulletRules =
 	7, // radius
 	0.8, // gravity factor
 };
+Vec2 level2Player1Locs[] =
+{
+	Vec2(160, 240),
+};
 PlayerRules level2Player1Rules =
 {
-	// waypoints
-	{
-		ofPoint(160, 240),
-	},
+	level2Player1Locs, // waypoints
 	1, // waypoint count
 	0.5, // speed
 	0, // initial rotation
 	0, // rotational velocity
 	36, // fire interval
-	ofPoint(0, -12), // fire velocity
+	Vec2(0, -12), // fire velocity
 	&level2Player1BulletRules,
 };
 EnemyRules level2EnemyRules =
@@ -86,6 +91,8 @@ GenericLevelRules level2Rules =
 	191, // gravity arrow alpha
 	191, // path projection alpha
 	75, // path projection count
+	NULL, // spawn waves
+	0, // spawn wave count
 };
 
 // LEVEL 3
@@ -94,18 +101,19 @@ BulletRules level3Player1BulletRules =
 	7, // radius
 	0.8, // gravity factor
 };
+Vec2 level3Player1Locs[] =
+{
+	Vec2(160, 240),
+};
 PlayerRules level3Player1Rules =
 {
-	// waypoints
-	{
-		ofPoint(160, 240),
-	},
+	level3Player1Locs, // waypoints
 	1, // waypoint count
 	0.5, // speed
 	-90, // initial rotation
 	0, // rotational velocity
 	26, // fire interval
-	ofPoint(0, -12), // fire velocity
+	Vec2(0, -12), // fire velocity
 	&level3Player1BulletRules,
 };
 EnemyRules level3EnemyRules =
@@ -126,6 +134,8 @@ GenericLevelRules level3Rules =
 	127, // gravity arrow alpha
 	127, // path projection alpha
 	50, // path projection count
+	NULL, // spawn waves
+	0, // spawn wave count
 };
 
 // LEVEL 4
@@ -134,18 +144,19 @@ BulletRules level4Player1BulletRules =
 	7, // radius
 	0.8, // gravity factor
 };
+Vec2 level4Player1Locs[] =
+{
+	Vec2(160, 240),
+};
 PlayerRules level4Player1Rules =
 {
-	// waypoints
-	{
-		ofPoint(160, 240),
-	},
+	level4Player1Locs, // waypoints
 	1, // waypoint count
 	0.5, // speed
 	90, // initial rotation
 	0, // rotational velocity
 	18, // fire interval
-	ofPoint(0, -12), // fire velocity
+	Vec2(0, -12), // fire velocity
 	&level4Player1BulletRules,
 };
 EnemyRules level4EnemyRules =
@@ -166,6 +177,8 @@ GenericLevelRules level4Rules =
 	63, // gravity arrow alpha
 	63, // path projection alpha
 	25, // path projection count
+	NULL, // spawn waves
+	0, // spawn wave count
 };
 
 // LEVEL 5
@@ -174,18 +187,19 @@ BulletRules level5Player1BulletRules =
 	7, // radius
 	0.8, // gravity factor
 };
+Vec2 level5Player1Locs[] =
+{
+	Vec2(160, 240),
+};
 PlayerRules level5Player1Rules =
 {
-	// waypoints
-	{
-		ofPoint(160, 240),
-	},
+	level5Player1Locs, // waypoints
 	1, // waypoint count
 	0.5, // speed
 	180, // initial rotation
 	0, // rotational velocity
 	12, // fire interval
-	ofPoint(0, -12), // fire velocity
+	Vec2(0, -12), // fire velocity
 	&level5Player1BulletRules,
 };
 EnemyRules level5EnemyRules =
@@ -206,6 +220,8 @@ GenericLevelRules level5Rules =
 	0, // gravity arrow alpha
 	0, // path projection alpha
 	0, // path projection count
+	NULL, // spawn waves
+	0, // spawn wave count
 };
 
 // LEVEL 6
@@ -214,19 +230,20 @@ BulletRules level6Player1BulletRules =
 	7, // radius
 	0.8, // gravity factor
 };
+Vec2 level6Player1Locs[] =
+{
+	Vec2(160, 160),
+	Vec2(160, 320),
+};
 PlayerRules level6Player1Rules =
 {
-	// waypoints
-	{
-		ofPoint(160, 160),
-		ofPoint(160, 320),
-	},
+	level6Player1Locs, // waypoints
 	2, // waypoint count
 	0.5, // speed
 	90, // initial rotation
 	0, // rotational velocity
 	12, // fire interval
-	ofPoint(0, -12), // fire velocity
+	Vec2(0, -12), // fire velocity
 	&level6Player1BulletRules,
 };
 EnemyRules level6EnemyRules =
@@ -247,6 +264,8 @@ GenericLevelRules level6Rules =
 	0, // gravity arrow alpha
 	0, // path projection alpha
 	0, // path projection count
+	NULL, // spawn waves
+	0, // spawn wave count
 };
 
 // LEVEL 7
@@ -255,21 +274,22 @@ BulletRules level7Player1BulletRules =
 	7, // radius
 	0.8, // gravity factor
 };
+Vec2 level7Player1Locs[] =
+{
+	Vec2(100, 180),
+	Vec2(220, 180),
+	Vec2(220, 300),
+	Vec2(100, 300),
+};
 PlayerRules level7Player1Rules =
 {
-	// waypoints
-	{
-		ofPoint(100, 180),
-		ofPoint(220, 180),
-		ofPoint(220, 300),
-		ofPoint(100, 300),
-	},
+	level7Player1Locs, // waypoints
 	4, // waypoint count
 	0.5, // speed
 	0, // initial rotation
 	0, // rotational velocity
 	12, // fire interval
-	ofPoint(0, -12), // fire velocity
+	Vec2(0, -12), // fire velocity
 	&level7Player1BulletRules,
 };
 EnemyRules level7EnemyRules =
@@ -290,6 +310,8 @@ GenericLevelRules level7Rules =
 	0, // gravity arrow alpha
 	0, // path projection alpha
 	0, // path projection count
+	NULL, // spawn waves
+	0, // spawn wave count
 };
 
 // LEVEL 8
@@ -298,18 +320,19 @@ BulletRules level8Player1BulletRules =
 	7, // radius
 	0.8, // gravity factor
 };
+Vec2 level8Player1Locs[] =
+{
+	Vec2(160, 240),
+};
 PlayerRules level8Player1Rules =
 {
-	// waypoints
-	{
-		ofPoint(160, 240),
-	},
+	level8Player1Locs, // waypoints
 	1, // waypoint count
 	0.5, // speed
 	0, // initial rotation
 	0.1, // rotational velocity
 	12, // fire interval
-	ofPoint(0, -12), // fire velocity
+	Vec2(0, -12), // fire velocity
 	&level8Player1BulletRules,
 };
 EnemyRules level8EnemyRules =
@@ -330,6 +353,8 @@ GenericLevelRules level8Rules =
 	0, // gravity arrow alpha
 	0, // path projection alpha
 	0, // path projection count
+	NULL, // spawn waves
+	0, // spawn wave count
 };
 
 // LEVEL 9
@@ -338,18 +363,19 @@ BulletRules level9Player1BulletRules =
 	7, // radius
 	0.8, // gravity factor
 };
+Vec2 level9Player1Locs[] =
+{
+	Vec2(160, 240),
+};
 PlayerRules level9Player1Rules =
 {
-	// waypoints
-	{
-		ofPoint(160, 240),
-	},
+	level9Player1Locs, // waypoints
 	1, // waypoint count
 	0.5, // speed
 	0, // initial rotation
 	-0.2, // rotational velocity
 	12, // fire interval
-	ofPoint(0, -12), // fire velocity
+	Vec2(0, -12), // fire velocity
 	&level9Player1BulletRules,
 };
 EnemyRules level9EnemyRules =
@@ -370,6 +396,8 @@ GenericLevelRules level9Rules =
 	0, // gravity arrow alpha
 	0, // path projection alpha
 	0, // path projection count
+	NULL, // spawn waves
+	0, // spawn wave count
 };
 
 // LEVEL 10
@@ -378,19 +406,20 @@ BulletRules level10Player1BulletRules =
 	7, // radius
 	0.8, // gravity factor
 };
+Vec2 level10Player1Locs[] =
+{
+	Vec2(160, 160),
+	Vec2(160, 320),
+};
 PlayerRules level10Player1Rules =
 {
-	// waypoints
-	{
-		ofPoint(160, 160),
-		ofPoint(160, 320),
-	},
+	level10Player1Locs, // waypoints
 	2, // waypoint count
 	0.5, // speed
 	0, // initial rotation
 	-0.25, // rotational velocity
 	12, // fire interval
-	ofPoint(0, -12), // fire velocity
+	Vec2(0, -12), // fire velocity
 	&level10Player1BulletRules,
 };
 EnemyRules level10EnemyRules =
@@ -411,6 +440,8 @@ GenericLevelRules level10Rules =
 	0, // gravity arrow alpha
 	0, // path projection alpha
 	0, // path projection count
+	NULL, // spawn waves
+	0, // spawn wave count
 };
 
 // LEVEL 11
@@ -419,21 +450,22 @@ BulletRules level11Player1BulletRules =
 	7, // radius
 	0.8, // gravity factor
 };
+Vec2 level11Player1Locs[] =
+{
+	Vec2(100, 180),
+	Vec2(220, 180),
+	Vec2(220, 300),
+	Vec2(100, 300),
+};
 PlayerRules level11Player1Rules =
 {
-	// waypoints
-	{
-		ofPoint(100, 180),
-		ofPoint(220, 180),
-		ofPoint(220, 300),
-		ofPoint(100, 300),
-	},
+	level11Player1Locs, // waypoints
 	4, // waypoint count
 	0.5, // speed
 	0, // initial rotation
 	0.25, // rotational velocity
 	12, // fire interval
-	ofPoint(0, -12), // fire velocity
+	Vec2(0, -12), // fire velocity
 	&level11Player1BulletRules,
 };
 EnemyRules level11EnemyRules =
@@ -454,6 +486,8 @@ GenericLevelRules level11Rules =
 	0, // gravity arrow alpha
 	0, // path projection alpha
 	0, // path projection count
+	NULL, // spawn waves
+	0, // spawn wave count
 };
 
 // LEVEL 12
@@ -462,18 +496,19 @@ BulletRules level12Player1BulletRules =
 	7, // radius
 	0.8, // gravity factor
 };
+Vec2 level12Player1Locs[] =
+{
+	Vec2(160, 160),
+};
 PlayerRules level12Player1Rules =
 {
-	// waypoints
-	{
-		ofPoint(160, 160),
-	},
+	level12Player1Locs, // waypoints
 	1, // waypoint count
 	0.5, // speed
 	90, // initial rotation
 	0, // rotational velocity
 	12, // fire interval
-	ofPoint(0, -12), // fire velocity
+	Vec2(0, -12), // fire velocity
 	&level12Player1BulletRules,
 };
 BulletRules level12Player2BulletRules =
@@ -481,18 +516,19 @@ BulletRules level12Player2BulletRules =
 	7, // radius
 	0.8, // gravity factor
 };
+Vec2 level12Player2Locs[] =
+{
+	Vec2(160, 320),
+};
 PlayerRules level12Player2Rules =
 {
-	// waypoints
-	{
-		ofPoint(160, 320),
-	},
+	level12Player2Locs, // waypoints
 	1, // waypoint count
 	0.5, // speed
 	90, // initial rotation
 	0, // rotational velocity
 	12, // fire interval
-	ofPoint(0, -12), // fire velocity
+	Vec2(0, -12), // fire velocity
 	&level12Player2BulletRules,
 };
 EnemyRules level12EnemyRules =
@@ -500,6 +536,12 @@ EnemyRules level12EnemyRules =
 	16, // radius
 	0.5, // speed
 };
+SpawnWave level12SpawnWaves[] =
+{
+	{0, 19, 250, 350, 0, 360, &level12EnemyRules}, // frame, count, distance, degrees, rules
+	{200, 18, 250, 350, 0, 360, &level12EnemyRules}, // frame, count, distance, degrees, rules
+	{400, 18, 250, 350, 0, 360, &level12EnemyRules}, // frame, count, distance, degrees, rules
+};
 GenericLevelRules level12Rules =
 {
 	// players
@@ -514,6 +556,8 @@ GenericLevelRules level12Rules =
 	0, // gravity arrow alpha
 	0, // path projection alpha
 	0, // path projection count
+	level12SpawnWaves, // spawn waves
+	3, // spawn wave count
 };
 
 // LEVEL 13
@@ -522,21 +566,22 @@ BulletRules level13Player1BulletRules =
 	7, // radius
 	0.8, // gravity factor
 };
+Vec2 level13Player1Locs[] =
+{
+	Vec2(100, 180),
+	Vec2(220, 180),
+	Vec2(220, 300),
+	Vec2(100, 300),
+};
 PlayerRules level13Player1Rules =
 {
-	// waypoints
-	{
-		ofPoint(100, 180),
-		ofPoint(220, 180),
-		ofPoint(220, 300),
-		ofPoint(100, 300),
-	},
+	level13Player1Locs, // waypoints
 	4, // waypoint count
 	0.5, // speed
 	180, // initial rotation
 	0, // rotational velocity
 	12, // fire interval
-	ofPoint(0, -12), // fire velocity
+	Vec2(0, -12), // fire velocity
 	&level13Player1BulletRules,
 };
 BulletRules level13Player2BulletRules =
@@ -544,21 +589,22 @@ BulletRules level13Player2BulletRules =
 	7, // radius
 	0.8, // gravity factor
 };
+Vec2 level13Player2Locs[] =
+{
+	Vec2(220, 300),
+	Vec2(100, 300),
+	Vec2(100, 180),
+	Vec2(220, 180),
+};
 PlayerRules level13Player2Rules =
 {
-	// waypoints
-	{
-		ofPoint(220, 300),
-		ofPoint(100, 300),
-		ofPoint(100, 180),
-		ofPoint(220, 180),
-	},
+	level13Player2Locs, // waypoints
 	4, // waypoint count
 	0.5, // speed
 	180, // initial rotation
 	0, // rotational velocity
 	12, // fire interval
-	ofPoint(0, -12), // fire velocity
+	Vec2(0, -12), // fire velocity
 	&level13Player2BulletRules,
 };
 EnemyRules level13EnemyRules =
@@ -566,6 +612,12 @@ EnemyRules level13EnemyRules =
 	16, // radius
 	0.5, // speed
 };
+SpawnWave level13SpawnWaves[] =
+{
+	{0, 20, 250, 350, 0, 360, &level13EnemyRules}, // frame, count, distance, degrees, rules
+	{200, 20, 250, 350, 0, 360, &level13EnemyRules}, // frame, count, distance, degrees, rules
+	{400, 20, 250, 350, 0, 360, &level13EnemyRules}, // frame, count, distance, degrees, rules
+};
 GenericLevelRules level13Rules =
 {
 	// players
@@ -580,6 +632,8 @@ GenericLevelRules level13Rules =
 	0, // gravity arrow alpha
 	0, // path projection alpha
 	0, // path projection count
+	level13SpawnWaves, // spawn waves
+	3, // spawn wave count
 };
 
 // LEVEL 14
@@ -588,18 +642,19 @@ BulletRules level14Player1BulletRules =
 	7, // radius
 	0.8, // gravity factor
 };
+Vec2 level14Player1Locs[] =
+{
+	Vec2(160, 160),
+};
 PlayerRules level14Player1Rules =
 {
-	// waypoints
-	{
-		ofPoint(160, 160),
-	},
+	level14Player1Locs, // waypoints
 	1, // waypoint count
 	0.5, // speed
 	0, // initial rotation
 	-0.25, // rotational velocity
 	12, // fire interval
-	ofPoint(0, -12), // fire velocity
+	Vec2(0, -12), // fire velocity
 	&level14Player1BulletRules,
 };
 BulletRules level14Player2BulletRules =
@@ -607,18 +662,19 @@ BulletRules level14Player2BulletRules =
 	7, // radius
 	0.8, // gravity factor
 };
+Vec2 level14Player2Locs[] =
+{
+	Vec2(160, 320),
+};
 PlayerRules level14Player2Rules =
 {
-	// waypoints
-	{
-		ofPoint(160, 320),
-	},
+	level14Player2Locs, // waypoints
 	1, // waypoint count
 	0.5, // speed
 	0, // initial rotation
 	-0.25, // rotational velocity
 	12, // fire interval
-	ofPoint(0, -12), // fire velocity
+	Vec2(0, -12), // fire velocity
 	&level14Player2BulletRules,
 };
 EnemyRules level14EnemyRules =
@@ -626,6 +682,12 @@ EnemyRules level14EnemyRules =
 	16, // radius
 	0.5, // speed
 };
+SpawnWave level14SpawnWaves[] =
+{
+	{0, 22, 250, 350, 0, 360, &level14EnemyRules}, // frame, count, distance, degrees, rules
+	{200, 22, 250, 350, 0, 360, &level14EnemyRules}, // frame, count, distance, degrees, rules
+	{400, 21, 250, 350, 0, 360, &level14EnemyRules}, // frame, count, distance, degrees, rules
+};
 GenericLevelRules level14Rules =
 {
 	// players
@@ -640,6 +702,8 @@ GenericLevelRules level14Rules =
 	0, // gravity arrow alpha
 	0, // path projection alpha
 	0, // path projection count
+	level14SpawnWaves, // spawn waves
+	3, // spawn wave count
 };
 
 // LEVEL 15
@@ -648,21 +712,22 @@ BulletRules level15Player1BulletRules =
 	7, // radius
 	0.8, // gravity factor
 };
+Vec2 level15Player1Locs[] =
+{
+	Vec2(100, 180),
+	Vec2(220, 180),
+	Vec2(220, 300),
+	Vec2(100, 300),
+};
 PlayerRules level15Player1Rules =
 {
-	// waypoints
-	{
-		ofPoint(100, 180),
-		ofPoint(220, 180),
-		ofPoint(220, 300),
-		ofPoint(100, 300),
-	},
+	level15Player1Locs, // waypoints
 	4, // waypoint count
 	0.5, // speed
 	180, // initial rotation
 	0.25, // rotational velocity
 	12, // fire interval
-	ofPoint(0, -12), // fire velocity
+	Vec2(0, -12), // fire velocity
 	&level15Player1BulletRules,
 };
 BulletRules level15Player2BulletRules =
@@ -670,21 +735,22 @@ BulletRules level15Player2BulletRules =
 	7, // radius
 	0.8, // gravity factor
 };
+Vec2 level15Player2Locs[] =
+{
+	Vec2(220, 300),
+	Vec2(100, 300),
+	Vec2(100, 180),
+	Vec2(220, 180),
+};
 PlayerRules level15Player2Rules =
 {
-	// waypoints
-	{
-		ofPoint(220, 300),
-		ofPoint(100, 300),
-		ofPoint(100, 180),
-		ofPoint(220, 180),
-	},
+	level15Player2Locs, // waypoints
 	4, // waypoint count
 	0.5, // speed
 	180, // initial rotation
 	0.25, // rotational velocity
 	12, // fire interval
-	ofPoint(0, -12), // fire velocity
+	Vec2(0, -12), // fire velocity
 	&level15Player2BulletRules,
 };
 EnemyRules level15EnemyRules =
@@ -692,6 +758,12 @@ EnemyRules level15EnemyRules =
 	16, // radius
 	0.5, // speed
 };
+SpawnWave level15SpawnWaves[] =
+{
+	{0, 24, 250, 350, 0, 360, &level15EnemyRules}, // frame, count, distance, degrees, rules
+	{200, 23, 250, 350, 0, 360, &level15EnemyRules}, // frame, count, distance, degrees, rules
+	{400, 23, 250, 350, 0, 360, &level15EnemyRules}, // frame, count, distance, degrees, rules
+};
 GenericLevelRules level15Rules =
 {
 	// players
@@ -706,6 +778,8 @@ GenericLevelRules level15Rules =
 	0, // gravity arrow alpha
 	0, // path projection alpha
 	0, // path projection count
+	level15SpawnWaves, // spawn waves
+	3, // spawn wave count
 };
 
 // 15 LEVELS.
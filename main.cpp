@@ -1,12 +1,60 @@
 #include "ofMain.h"
 #include "App.h"
+#include "TuningFarm.h"
+#include "RenderBenchmark.h"
+#include "TelemetryViewer.h"
+#include "rules.h"
+#include <string.h>
 
 /**
  * Main application entry point.
  * Sets up Open Frameworks and then runs the app.
+ * With --tune [games per level] [threads] [aimed|scripted|random], plays every level
+ * headlessly on a TuningFarm and prints the results instead.
+ * With --render [level] [frames] [image.ppm], plays one level headlessly, draws it
+ * with the software renderer as recorded and then sorted, prints what drawing cost
+ * each way, and saves the last sorted frame.
+ * With --watch [seconds], prints a summary of a running game's telemetry every
+ * second until killed or for the specified time.
  */
 int main(int argc, char *argv[])
 {
+	if(argc > 1 && strcmp(argv[1], "--tune") == 0)
+	{
+		int games = argc > 2 ? atoi(argv[2]) : TUNING_GAMES_PER_LEVEL;
+		int threads = argc > 3 ? atoi(argv[3]) : ThreadPool::coreCount();
+		TuningGravity gravity = TUNING_GRAVITY_AIMED;
+		if(argc > 4 && strcmp(argv[4], "scripted") == 0)
+			gravity = TUNING_GRAVITY_SCRIPTED;
+		else if(argc > 4 && strcmp(argv[4], "random") == 0)
+			gravity = TUNING_GRAVITY_RANDOM;
+		
+		TuningFarm farm(games, threads, gravity);
+		farm.run();
+		farm.print();
+		return 0;
+	}
+	
+	if(argc > 1 && strcmp(argv[1], "--render") == 0)
+	{
+		int level = argc > 2 ? atoi(argv[2]) : 1;
+		int frames = argc > 3 ? atoi(argv[3]) : RENDER_BENCH_FRAMES;
+		RenderBenchmark unsorted(level, frames, false);
+		unsorted.run();
+		unsorted.print();
+		RenderBenchmark sorted(level, frames, true);
+		sorted.run(argc > 4 ? argv[4] : NULL);
+		sorted.print();
+		return 0;
+	}
+	
+	if(argc > 1 && strcmp(argv[1], "--watch") == 0)
+	{
+		TelemetryViewer viewer;
+		viewer.run(argc > 2 ? atoi(argv[2]) : 0);
+		return 0;
+	}
+	
 	ofSetupOpenGL(1024, 768, OF_FULLSCREEN);
 	ofRunApp(new App());
 }
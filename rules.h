@@ -6,7 +6,9 @@
 
 #define SCREEN_WIDTH 320
 #define SCREEN_HEIGHT 480
-#define SCREEN_CENTER ofPoint(160, 240)
+#define SCREEN_CENTER Vec2(160, 240)
+
+#define FAST_MATH 0
 
 #define PLAYER_CIRCLE_R 255
 #define PLAYER_CIRCLE_G 255
@@ -32,15 +34,18 @@
 #define BULLET_B 255
 #define BULLET_A 255
 #define BULLET_DELETE_THRESHOLD 100
+#define HIT_PREDICTION 1
+#define HIT_PREDICTION_STEADY_FRAMES 10
 
 #define DUST_R 255
 #define DUST_G 255
 #define DUST_B 255
-#define DUST_A 31
-#define DUST_RAD 10
+#define DUST_A 47
+#define DUST_RAD 1.5
 #define DUST_GRAVITY_FACTOR .8
 #define DUST_FRICTION .75
-#define DUST_COUNT 10
+#define DUST_COUNT 4000
+#define DUST_SEED_MIX 0x2545f491
 
 #define ENEMY_R 255
 #define ENEMY_G 0
@@ -54,6 +59,52 @@
 #define ENEMY_DEATH_A 255
 #define ENEMY_DEATH_DURATION 30
 #define ENEMY_DEATH_RAD_FACTOR 2
+#define ENEMY_LOD 1
+#define ENEMY_LOD_MIN_SLEEP_FRAMES 8
+#define ENEMY_LOD_WAKE_MARGIN 2
+
+#define SIM_THREAD 1
+#define SIM_TICK_RATE 60
+#define SIM_MAX_LAG_TICKS 5
+
+#define FRAME_PACING 1
+#define PACE_FULL_RATE 60
+#define PACE_REDUCED_RATE 30
+#define PACE_IDLE_RATE 10
+#define PACE_REDUCE_FRAMES 30
+#define PACE_IDLE_FRAMES 30
+
+#define QUALITY_SCALING 1
+#define QUALITY_LEVEL_COUNT 4
+#define QUALITY_SMOOTHING 0.1
+#define QUALITY_OVER_FRACTION 0.9
+#define QUALITY_UNDER_FRACTION 0.6
+#define QUALITY_DOWN_FRAMES 30
+#define QUALITY_UP_FRAMES 180
+#define QUALITY_MINOR_EFFECT_RAD 64
+
+#define ACCEL_SAMPLER 1
+#define ACCEL_FILTER 0.3
+
+#define PARALLEL_UPDATE 0
+#define UPDATE_CHUNK_SIZE 256
+#define PARALLEL_RENDER 1
+#define RENDER_CHUNK_SIZE 512
+#define COMMAND_LOG 0
+
+#define TRACING 0
+#define TRACE_BUFFER_EVENTS 65536
+#define TRACE_FILE "trace.json"
+#define TRACE_FLUSH_MICROS 2000000
+#define TELEMETRY 0
+#define TELEMETRY_NAME "/game.telemetry"
+#define TELEMETRY_RECORDS 1024
+#define TELEMETRY_VIEW_MICROS 1000000
+
+#define REWIND_DEBUG 0
+#define REWIND_CAPTURE_INTERVAL 6
+#define REWIND_SNAPSHOT_COUNT 50
+#define REWIND_TAP_SNAPSHOTS 10
 
 #define WIN_R 255
 #define WIN_G 255
@@ -104,6 +155,41 @@
 #define PATH_PROJECTION_B 255
 #define PATH_PROJECTION_A 255
 
+#define STRESS_BENCHMARK 0
+#define STRESS_TARGET_TICK_RATE 60
+#define STRESS_WARMUP_FRAMES 10
+#define STRESS_SAMPLE_FRAMES 60
+#define STRESS_EMITTER_COUNT 24
+#define STRESS_EMITTER_RING_RAD 80
+#define STRESS_EMITTER_ROT_VEL 3
+#define STRESS_FIRE_INTERVAL 2
+#define STRESS_ENEMY_RAD 8
+#define STRESS_SPAWN_MIN_DIST 120
+#define STRESS_SPAWN_MAX_DIST 300
+#define STRESS_ENEMY_SPEED 0.5
+#define STRESS_BULLET_RAD 4
+#define STRESS_GRAVITY_FACTOR 0.8
+
+#define TUNING_GAMES_PER_LEVEL 1000
+#define TUNING_MAX_FRAMES 36000
+#define TUNING_SEED 1
+#define TUNING_GRAVITY_HOLD_FRAMES 120
+#define TUNING_GRAVITY_MAX 0.6
+#define TUNING_AIM_FLIGHT_FRAMES 120
+
+#define RENDER_SORT 1
+#define OFFSCREEN_TARGET 1
+#define RENDER_SCALE 1.0
+#define RENDER_MIN_SCALE 0.25
+#define SDF_CIRCLES 1
+#define CIRCLE_TEXTURE_SIZE 256
+#define CIRCLE_TEXTURE_FILL 0.75
+#define CIRCLE_MESH_TOLERANCE 0.1
+#define POINT_SPRITES 1
+
+#define RENDER_BENCH_FRAMES 600
+#define RENDER_BENCH_SEED 1
+
 struct GenericLevelRules;
 extern GenericLevelRules* levels[];
 #define LEVEL_COUNT 15
\ No newline at end of file